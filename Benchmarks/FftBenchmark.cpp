@@ -0,0 +1,98 @@
+/**
+ * FftBenchmark — times every FftBackend on the same input, by default at the
+ * sizes SNOT's spectral code runs: SpectralWarpChorus's 256 … 2048-point
+ * frames, which include the analyser's 1024. Each backend is also checked
+ * against juce::dsp::FFT's output.
+ *
+ *     SNOTFftBenchmark [minOrder maxOrder [iterations]]
+ */
+#include <JuceHeader.h>
+#include "FftBackend.h"
+#include <iostream>
+
+namespace
+{
+    struct Result
+    {
+        int              size      { 0 };
+        FftBackend::Kind kind      { FftBackend::Kind::bundled };
+        double           nsPerPair { 0.0 }; // one forward plus one inverse
+        double           maxError  { 0.0 }; // largest bin deviation from juce::dsp::FFT
+    };
+
+    std::vector<Result> run (int minOrder, int maxOrder, int iterations)
+    {
+        std::vector<Result> results;
+        juce::Random random (0x5eed);
+
+        for (int order = minOrder; order <= maxOrder; ++order)
+        {
+            const int size = 1 << order;
+            std::vector<float> input (static_cast<size_t> (size));
+            for (auto& x : input)
+                x = random.nextFloat() * 2.0f - 1.0f;
+
+            // Reference spectrum
+            std::vector<float> reference (static_cast<size_t> (size * 2), 0.0f);
+            std::copy (input.begin(), input.end(), reference.begin());
+            FftBackend::create (order, FftBackend::Kind::juce)->forward (reference.data());
+
+            for (auto kind : { FftBackend::Kind::juce, FftBackend::Kind::bundled })
+            {
+                const auto fft = FftBackend::create (order, kind);
+                std::vector<float> data (static_cast<size_t> (size * 2), 0.0f);
+
+                std::copy (input.begin(), input.end(), data.begin());
+                fft->forward (data.data());
+                double maxError = 0.0;
+                for (int i = 0; i < size + 2; ++i)
+                    maxError = juce::jmax (maxError, static_cast<double> (std::abs (data[(size_t) i] - reference[(size_t) i])));
+
+                // Forward + inverse is an identity, so the data stays bounded
+                const auto start = juce::Time::getHighResolutionTicks();
+                for (int i = 0; i < iterations; ++i)
+                {
+                    fft->forward (data.data());
+                    fft->inverse (data.data());
+                }
+                const auto ticks = juce::Time::getHighResolutionTicks() - start;
+
+                Result r;
+                r.size      = size;
+                r.kind      = fft->getKind();
+                r.nsPerPair = juce::Time::highResolutionTicksToSeconds (ticks) * 1.0e9 / iterations;
+                r.maxError  = maxError;
+                results.push_back (r);
+            }
+        }
+
+        return results;
+    }
+
+    juce::String format (const std::vector<Result>& results)
+    {
+        juce::String text ("size   backend   ns/fwd+inv   max |error|\n");
+        for (const auto& r : results)
+            text << juce::String (r.size).paddedRight (' ', 7)
+                 << juce::String (r.kind == FftBackend::Kind::juce ? "juce" : "bundled").paddedRight (' ', 10)
+                 << juce::String (r.nsPerPair, 0).paddedRight (' ', 13)
+                 << juce::String (r.maxError, 7) << "\n";
+        return text;
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    int minOrder = 8, maxOrder = 11, iterations = 2000;
+    if (argc >= 3)
+    {
+        minOrder = juce::jlimit (4, 13, juce::String (argv[1]).getIntValue());
+        maxOrder = juce::jlimit (minOrder, 13, juce::String (argv[2]).getIntValue());
+    }
+    if (argc >= 4)
+        iterations = juce::jmax (1, juce::String (argv[3]).getIntValue());
+
+    std::cout << format (run (minOrder, maxOrder, iterations)) << std::flush;
+    return 0;
+}
@@ -2,7 +2,8 @@
 
 /**
  * ParamIDs.h
- * All APVTS parameter ID string constants in one place.
+ * All APVTS parameter ID string constants in one place, and the table that
+ * defines every parameter from them (see ParamIndex::table).
  * This header has NO other dependencies — safe to include anywhere first.
  */
 namespace ParamID
@@ -28,6 +29,7 @@ namespace ParamID
     inline constexpr auto SWC_VOICES   = "swc_voices";
     inline constexpr auto SWC_WARP     = "swc_warp";
     inline constexpr auto SWC_MIX      = "swc_mix";
+    inline constexpr auto SWC_FRAME    = "swc_frame";
     inline constexpr auto SWC_ENABLED  = "swc_enabled";
 
     // PortalReverb
@@ -94,3 +96,202 @@ namespace ParamID
     inline constexpr auto ME_CHARACTER = "me_character";
     inline constexpr auto ME_ENABLED   = "me_enabled";
 }
+
+//==============================================================================
+/**
+ * One parameter's definition. ParamIndex::table holds them all, and
+ * everything else is generated from it: the APVTS layout, the dense
+ * indices the audio thread uses, and the manifest the web UI builds its
+ * controls from.
+ */
+struct ParamSpec
+{
+    enum Kind { floatParam, boolParam, choiceParam };
+
+    int         index;   // == position in the table
+    const char* id;
+    const char* module;  // UI module key ("pr", "swc", …), or "master" / "macro"
+    const char* name;    // host-facing
+    const char* label;   // inspector control label; nullptr for no control
+    Kind        kind;
+    float       min, max, def, skew;
+    const char* choices; // choiceParam: "|"-separated
+
+    constexpr int getNumChoices() const
+    {
+        int n = 1;
+        for (const char* c = choices; c != nullptr && *c != 0; ++c)
+            n += *c == '|' ? 1 : 0;
+        return n;
+    }
+};
+
+namespace ParamSpecs
+{
+    constexpr ParamSpec floating (int index, const char* id, const char* module, const char* name, const char* label,
+                                  float min, float max, float def, float skew = 1.0f)
+    {
+        return { index, id, module, name, label, ParamSpec::floatParam, min, max, def, skew, nullptr };
+    }
+
+    constexpr ParamSpec toggle (int index, const char* id, const char* module, const char* name, bool def)
+    {
+        return { index, id, module, name, nullptr, ParamSpec::boolParam, 0.0f, 1.0f, def ? 1.0f : 0.0f, 1.0f, nullptr };
+    }
+
+    constexpr ParamSpec choice (int index, const char* id, const char* module, const char* name, const char* label,
+                                const char* choices, int def)
+    {
+        ParamSpec spec { index, id, module, name, label, ParamSpec::choiceParam, 0.0f, 0.0f, static_cast<float> (def), 1.0f, choices };
+        spec.max = static_cast<float> (spec.getNumChoices() - 1);
+        return spec;
+    }
+}
+
+/**
+ * Dense parameter indices, in table order, which is also the order the
+ * layout adds them in: each one is the parameter's APVTS index and its
+ * ModulationBuses lane.
+ */
+namespace ParamIndex
+{
+    enum Index : int
+    {
+        MASTER_GAIN, MIX, OVERSAMPLE,
+        MACRO_1, MACRO_2, MACRO_3, MACRO_4, MACRO_5, MACRO_6, MACRO_7, MACRO_8,
+        SWC_DEPTH, SWC_RATE, SWC_VOICES, SWC_WARP, SWC_MIX, SWC_FRAME, SWC_ENABLED,
+        PR_SIZE, PR_DECAY, PR_DRIFT, PR_SHIMMER, PR_DAMPING, PR_MIX, PR_ENABLED,
+        PSD_TIME, PSD_FEEDBACK, PSD_SMEAR, PSD_SYNC, PSD_MIX, PSD_ENABLED,
+        H8_DRIVE, H8_PUNCH, H8_BLOOM, H8_TUNE, H8_MIX, H8_ENABLED,
+        GF_FREQ, GF_RESO, GF_CURVE, GF_MODE, GF_ENABLED,
+        PD_DRIVE, PD_CHARACTER, PD_BIAS, PD_MIX, PD_ENABLED,
+        SNM_WIDTH, SNM_MOTION, SNM_RATE, SNM_ENABLED,
+        TG_DENSITY, TG_CHARACTER, TG_MIX, TG_ENABLED,
+        FC_FREEZE, FC_SIZE, FC_PITCH, FC_MIX, FC_ENABLED,
+        ME_AMOUNT, ME_RATE, ME_CHARACTER, ME_ENABLED,
+        NUM_PARAMS
+    };
+
+    using namespace ParamSpecs;
+
+    inline constexpr ParamSpec table[] =
+    {
+        // Master
+        floating (MASTER_GAIN, ParamID::MASTER_GAIN, "master", "Master Gain", nullptr, 0.0f, 2.0f, 1.0f),
+        floating (MIX,         ParamID::MIX,         "master", "Mix",         nullptr, 0.0f, 1.0f, 1.0f),
+        choice   (OVERSAMPLE,  ParamID::OVERSAMPLE,  "master", "Oversampling", nullptr, "1x|2x|4x|8x", 1),
+
+        // Macros
+        floating (MACRO_1, ParamID::MACRO_1, "macro", "Macro 1", nullptr, 0.0f, 1.0f, 0.0f),
+        floating (MACRO_2, ParamID::MACRO_2, "macro", "Macro 2", nullptr, 0.0f, 1.0f, 0.0f),
+        floating (MACRO_3, ParamID::MACRO_3, "macro", "Macro 3", nullptr, 0.0f, 1.0f, 0.0f),
+        floating (MACRO_4, ParamID::MACRO_4, "macro", "Macro 4", nullptr, 0.0f, 1.0f, 0.0f),
+        floating (MACRO_5, ParamID::MACRO_5, "macro", "Macro 5", nullptr, 0.0f, 1.0f, 0.0f),
+        floating (MACRO_6, ParamID::MACRO_6, "macro", "Macro 6", nullptr, 0.0f, 1.0f, 0.0f),
+        floating (MACRO_7, ParamID::MACRO_7, "macro", "Macro 7", nullptr, 0.0f, 1.0f, 0.0f),
+        floating (MACRO_8, ParamID::MACRO_8, "macro", "Macro 8", nullptr, 0.0f, 1.0f, 0.0f),
+
+        // Spectral Warp Chorus
+        floating (SWC_DEPTH,   ParamID::SWC_DEPTH,   "swc", "SWC Depth",  "Depth",  0.0f,  1.0f,  0.5f),
+        floating (SWC_RATE,    ParamID::SWC_RATE,    "swc", "SWC Rate",   "Rate",   0.01f, 10.0f, 0.5f, 0.4f),
+        floating (SWC_VOICES,  ParamID::SWC_VOICES,  "swc", "SWC Voices", "Voices", 1.0f,  8.0f,  4.0f),
+        floating (SWC_WARP,    ParamID::SWC_WARP,    "swc", "SWC Warp",   "Warp",   0.0f,  1.0f,  0.3f),
+        floating (SWC_MIX,     ParamID::SWC_MIX,     "swc", "SWC Mix",    "Mix",    0.0f,  1.0f,  0.6f),
+        choice   (SWC_FRAME,   ParamID::SWC_FRAME,   "swc", "SWC Frame",  "Frame",  "256|512|1024|2048|Hybrid (lows lag)", 3),
+        toggle   (SWC_ENABLED, ParamID::SWC_ENABLED, "swc", "SWC Enable", true),
+
+        // Portal Reverb
+        floating (PR_SIZE,    ParamID::PR_SIZE,    "pr", "Reverb Size",    "Size",    0.0f, 1.0f,  0.7f),
+        floating (PR_DECAY,   ParamID::PR_DECAY,   "pr", "Reverb Decay",   "Decay",   0.1f, 60.0f, 8.0f, 0.3f),
+        floating (PR_DRIFT,   ParamID::PR_DRIFT,   "pr", "Reverb Drift",   "Drift",   0.0f, 1.0f,  0.4f),
+        floating (PR_SHIMMER, ParamID::PR_SHIMMER, "pr", "Reverb Shimmer", "Shimmer", 0.0f, 1.0f,  0.2f),
+        floating (PR_DAMPING, ParamID::PR_DAMPING, "pr", "Reverb Damping", "Damping", 0.0f, 1.0f,  0.3f),
+        floating (PR_MIX,     ParamID::PR_MIX,     "pr", "Reverb Mix",     "Mix",     0.0f, 1.0f,  0.4f),
+        toggle   (PR_ENABLED, ParamID::PR_ENABLED, "pr", "Reverb Enable",  true),
+
+        // Pitch Smear Delay
+        floating (PSD_TIME,     ParamID::PSD_TIME,     "psd", "Delay Time",     "Time",     0.01f, 4.0f,  0.25f, 0.4f),
+        floating (PSD_FEEDBACK, ParamID::PSD_FEEDBACK, "psd", "Delay Feedback", "Feedback", 0.0f,  0.99f, 0.4f),
+        floating (PSD_SMEAR,    ParamID::PSD_SMEAR,    "psd", "Delay Smear",    "Smear",    0.0f,  1.0f,  0.3f),
+        toggle   (PSD_SYNC,     ParamID::PSD_SYNC,     "psd", "Delay Sync",     true),
+        floating (PSD_MIX,      ParamID::PSD_MIX,      "psd", "Delay Mix",      "Mix",      0.0f,  1.0f,  0.4f),
+        toggle   (PSD_ENABLED,  ParamID::PSD_ENABLED,  "psd", "Delay Enable",   true),
+
+        // 808 Inflator
+        floating (H8_DRIVE,   ParamID::H8_DRIVE,   "h8", "808 Drive",  "Drive", 0.0f,   1.0f,  0.3f),
+        floating (H8_PUNCH,   ParamID::H8_PUNCH,   "h8", "808 Punch",  "Punch", 0.0f,   1.0f,  0.5f),
+        floating (H8_BLOOM,   ParamID::H8_BLOOM,   "h8", "808 Bloom",  "Bloom", 0.0f,   1.0f,  0.2f),
+        floating (H8_TUNE,    ParamID::H8_TUNE,    "h8", "808 Tune",   nullptr, -24.0f, 24.0f, 0.0f),
+        floating (H8_MIX,     ParamID::H8_MIX,     "h8", "808 Mix",    "Mix",   0.0f,   1.0f,  0.8f),
+        toggle   (H8_ENABLED, ParamID::H8_ENABLED, "h8", "808 Enable", false),
+
+        // Gravity Filter
+        floating (GF_FREQ,    ParamID::GF_FREQ,    "gf", "Filter Freq",   "Freq",  20.0f, 20000.0f, 2000.0f, 0.25f),
+        floating (GF_RESO,    ParamID::GF_RESO,    "gf", "Filter Reso",   "Reso",  0.0f,  1.0f,     0.3f),
+        floating (GF_CURVE,   ParamID::GF_CURVE,   "gf", "Filter Curve",  "Curve", -1.0f, 1.0f,     0.0f),
+        choice   (GF_MODE,    ParamID::GF_MODE,    "gf", "Filter Mode",   nullptr, "LP|HP|BP|Notch|Gravity", 4),
+        toggle   (GF_ENABLED, ParamID::GF_ENABLED, "gf", "Filter Enable", true),
+
+        // Plasma Distortion
+        floating (PD_DRIVE,     ParamID::PD_DRIVE,     "pd", "Plasma Drive",     "Drive",     0.0f,  1.0f, 0.4f),
+        floating (PD_CHARACTER, ParamID::PD_CHARACTER, "pd", "Plasma Character", "Character", 0.0f,  1.0f, 0.5f),
+        floating (PD_BIAS,      ParamID::PD_BIAS,      "pd", "Plasma Bias",      "Bias",      -1.0f, 1.0f, 0.0f),
+        floating (PD_MIX,       ParamID::PD_MIX,       "pd", "Plasma Mix",       "Mix",       0.0f,  1.0f, 0.5f),
+        toggle   (PD_ENABLED,   ParamID::PD_ENABLED,   "pd", "Plasma Enable",    false),
+
+        // Stereo Neural Motion
+        floating (SNM_WIDTH,   ParamID::SNM_WIDTH,   "snm", "SNM Width",  "Width",  0.0f,  2.0f, 1.0f),
+        floating (SNM_MOTION,  ParamID::SNM_MOTION,  "snm", "SNM Motion", "Motion", 0.0f,  1.0f, 0.3f),
+        floating (SNM_RATE,    ParamID::SNM_RATE,    "snm", "SNM Rate",   "Rate",   0.01f, 4.0f, 0.2f, 0.4f),
+        toggle   (SNM_ENABLED, ParamID::SNM_ENABLED, "snm", "SNM Enable", true),
+
+        // Texture Generator
+        floating (TG_DENSITY,   ParamID::TG_DENSITY,   "tg", "Texture Density",   "Density",   0.0f, 1.0f, 0.2f),
+        floating (TG_CHARACTER, ParamID::TG_CHARACTER, "tg", "Texture Character", "Character", 0.0f, 1.0f, 0.5f),
+        floating (TG_MIX,       ParamID::TG_MIX,       "tg", "Texture Mix",       "Mix",       0.0f, 1.0f, 0.15f),
+        toggle   (TG_ENABLED,   ParamID::TG_ENABLED,   "tg", "Texture Enable",    false),
+
+        // Freeze Capture
+        toggle   (FC_FREEZE,  ParamID::FC_FREEZE,  "fc", "Freeze",        false),
+        floating (FC_SIZE,    ParamID::FC_SIZE,    "fc", "Freeze Size",   "Size",  0.01f,  4.0f,  0.5f, 0.5f),
+        floating (FC_PITCH,   ParamID::FC_PITCH,   "fc", "Freeze Pitch",  "Pitch", -24.0f, 24.0f, 0.0f),
+        floating (FC_MIX,     ParamID::FC_MIX,     "fc", "Freeze Mix",    "Mix",   0.0f,   1.0f,  1.0f),
+        toggle   (FC_ENABLED, ParamID::FC_ENABLED, "fc", "Freeze Enable", false),
+
+        // Mutation Engine
+        floating (ME_AMOUNT,    ParamID::ME_AMOUNT,    "me", "Mutation Amount",    "Amount",    0.0f,  1.0f, 0.2f),
+        floating (ME_RATE,      ParamID::ME_RATE,      "me", "Mutation Rate",      "Rate",      0.01f, 8.0f, 0.5f, 0.4f),
+        floating (ME_CHARACTER, ParamID::ME_CHARACTER, "me", "Mutation Character", "Character", 0.0f,  1.0f, 0.5f),
+        toggle   (ME_ENABLED,   ParamID::ME_ENABLED,   "me", "Mutation Enable",    false),
+    };
+
+    static_assert (sizeof (table) / sizeof (table[0]) == NUM_PARAMS, "ParamIndex::table out of step with Index");
+
+    constexpr bool isTableInOrder()
+    {
+        for (int i = 0; i < NUM_PARAMS; ++i)
+            if (table[i].index != i)
+                return false;
+        return true;
+    }
+
+    static_assert (isTableInOrder(), "ParamIndex::table rows must follow Index order");
+
+    constexpr const ParamSpec& spec (Index i) { return table[i]; }
+
+    /** The dense index of a parameter ID, or -1. Linear; resolve IDs once, off the audio thread. */
+    constexpr int indexOf (const char* paramID)
+    {
+        for (int i = 0; i < NUM_PARAMS; ++i)
+        {
+            const char* a = table[i].id;
+            const char* b = paramID;
+            while (*a != 0 && *a == *b) { ++a; ++b; }
+            if (*a == *b)
+                return i;
+        }
+        return -1;
+    }
+
+    static_assert (indexOf (ParamID::SWC_FRAME) == SWC_FRAME && indexOf (ParamID::ME_ENABLED) == ME_ENABLED);
+}
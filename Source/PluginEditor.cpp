@@ -149,19 +149,88 @@ void SnotWebEditor::timerCallback()
     }
     js += "]);}";
     browser->evaluateJavascript (js);
+
+    if (NodeProfileStats::isEnabled() && ++statsTick >= 12)
+    {
+        statsTick = 0;
+        pushNodeStats();
+    }
+}
+
+void SnotWebEditor::pushNodeStats()
+{
+    // { type: [meanNs, p99Ns, calls, skipped], ... } — ns per sample
+    String js = "if(window.SNOT&&window.SNOT.updateNodeStats)"
+                "{window.SNOT.updateNodeStats({";
+    bool first = true;
+    for (auto& [id, node] : proc.getModuleGraph().getNodes())
+    {
+        const auto s = node->getProfileStats().collect();
+        if (! first) js += ",";
+        first = false;
+        js += node->getType() + ":[" + String (s.meanNsPerSample, 2) + ","
+            + String (s.p99NsPerSample, 2) + "," + String ((int64) s.calls) + ","
+            + String ((int64) s.skipped) + "]";
+    }
+    js += "});}";
+    browser->evaluateJavascript (js);
+}
+
+void SnotWebEditor::pushParameterManifest()
+{
+    // The UI builds its controls from this, so it can't drift from the layout
+    auto& params = proc.getAPVTS().processor.getParameters();
+    Array<var> manifest;
+    for (const auto& spec : ParamIndex::table)
+    {
+        auto* param = dynamic_cast<RangedAudioParameter*> (params[spec.index]);
+        if (param == nullptr) continue;
+
+        auto* entry = new DynamicObject();
+        entry->setProperty ("id",     spec.id);
+        entry->setProperty ("module", spec.module);
+        entry->setProperty ("name",   spec.name);
+        entry->setProperty ("label",  spec.label != nullptr ? var (spec.label) : var());
+        entry->setProperty ("kind",   spec.kind == ParamSpec::floatParam ? "float"
+                                    : spec.kind == ParamSpec::boolParam  ? "bool" : "choice");
+        entry->setProperty ("min",    spec.min);
+        entry->setProperty ("max",    spec.max);
+        entry->setProperty ("def",    param->getDefaultValue());
+        entry->setProperty ("value",  param->getValue());
+        if (spec.kind == ParamSpec::choiceParam)
+        {
+            Array<var> choices;
+            for (const auto& c : StringArray::fromTokens (spec.choices, "|", ""))
+                choices.add (c);
+            entry->setProperty ("choices", choices);
+        }
+        manifest.add (var (entry));
+    }
+
+    browser->evaluateJavascript ("if(window.SNOT&&window.SNOT.setParamManifest)"
+                                 "{window.SNOT.setParamManifest("
+                                 + JSON::toString (var (manifest), true) + ");}");
 }
 
 void SnotWebEditor::parameterChanged (const String& paramID, float newValue)
 {
     if (!webViewReady || browser == nullptr) return;
-    MessageManager::callAsync ([this, paramID, newValue]
+
+    auto update = [this, paramID, newValue]
     {
         if (browser != nullptr)
             browser->evaluateJavascript (
                 "if(window.SNOT&&window.SNOT.updateParam)"
                 "{window.SNOT.updateParam('" + paramID + "',"
                 + String (newValue, 6) + ");}");
-    });
+    };
+
+    // Engine writes arrive here from ParameterWriteQueue, already on the
+    // message thread; only host automation still needs the hop
+    if (MessageManager::existsAndIsCurrentThread())
+        update();
+    else
+        MessageManager::callAsync (std::move (update));
 }
 
 //==============================================================================
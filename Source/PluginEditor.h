@@ -42,6 +42,8 @@ private:
             return true;
         }
 
+        void pageFinishedLoading (const juce::String&) override { owner.pushParameterManifest(); }
+
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SnotBrowser)
     private:
         SnotWebEditor& owner;
@@ -50,10 +52,13 @@ private:
 
     std::unique_ptr<SnotBrowser> browser;
     bool      webViewReady { false };
+    int       statsTick    { 0 };   // node stats go out every 12th frame (~2 Hz)
     juce::File htmlFile;  // temp copy of embedded HTML
 
     void buildBrowser();
     void handleSnotURL (const juce::String& url);
+    void pushNodeStats();
+    void pushParameterManifest();
     void registerParamListeners();
     void unregisterParamListeners();
 
@@ -9,32 +9,27 @@ SnotAudioProcessor::SnotAudioProcessor()
                      .withInput  ("Input",  AudioChannelSet::stereo(), true)
                      .withOutput ("Output", AudioChannelSet::stereo(), true)),
       apvts (*this, nullptr, "SNOT_STATE", createParameterLayout()),
-      fft (10),   // 1024-point FFT
-      window (1 << 10, dsp::WindowingFunction<float>::hann)
+      parameterSnapshot (apvts)
 {
-    fftBuffer.resize (1 << 11, 0.0f); // 2x for real FFT
+    spectrumStft.addSubscriber (this);
 
+    paramWriteQueue = std::make_unique<ParameterWriteQueue> (apvts);
     moduleGraph     = std::make_unique<ModuleGraph> (apvts);
     macroEngine     = std::make_unique<MacroEngine> (apvts);
     modMatrix       = std::make_unique<ModulationMatrix> (apvts);
-    oversamplingChain = std::make_unique<OversamplingChain>();
     gainStager      = std::make_unique<GainStager>();
-    midiRouter      = std::make_unique<MidiRouter> (apvts);
+    midiRouter      = std::make_unique<MidiRouter> (apvts, *paramWriteQueue);
     presetManager   = std::make_unique<PresetManager> (*this, apvts);
 
-    // Wire macros → modulation matrix
-    macroEngine->setModulationMatrix (modMatrix.get());
+    // Macros and the modulation matrix both write the buses the nodes read
+    moduleGraph->setBlockSources (&parameterSnapshot.getValues(), &modMatrix->getBuses(),
+                                  &parameterSnapshot.getTransport());
 
-    // Listen to key parameters
-    apvts.addParameterListener (ParamID::OVERSAMPLE, this);
-    apvts.addParameterListener (ParamID::MIX, this);
+    // Latency comes from oversampled regions and latent nodes such as SWC
+    moduleGraph->onLatencyChanged = [this] (int samples) { setLatencySamples (samples); };
 }
 
-SnotAudioProcessor::~SnotAudioProcessor()
-{
-    apvts.removeParameterListener (ParamID::OVERSAMPLE, this);
-    apvts.removeParameterListener (ParamID::MIX, this);
-}
+SnotAudioProcessor::~SnotAudioProcessor() = default;
 
 //==============================================================================
 void SnotAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
@@ -43,20 +38,26 @@ void SnotAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
                                   static_cast<uint32> (samplesPerBlock),
                                   static_cast<uint32> (getTotalNumOutputChannels()) };
 
-    oversamplingChain->prepare (spec);
     moduleGraph->prepare (sampleRate, samplesPerBlock,
                           getTotalNumOutputChannels());
     modMatrix->prepare (sampleRate, samplesPerBlock);
     gainStager->prepare (spec);
 
     dryBuffer.setSize (getTotalNumOutputChannels(), samplesPerBlock);
+    dryDelay.setSize (getTotalNumOutputChannels(), nextPowerOfTwo (MAX_DRY_DELAY + samplesPerBlock));
+    dryDelay.clear();
+    dryWritePos     = 0;
+    dryDelaySamples = moduleGraph->getLatencySamples();
+
+    const int spectrumSize = 1 << SPECTRUM_FFT_ORDER;
+    spectrumStft.prepare (SPECTRUM_FFT_ORDER, spectrumSize / 2, 1, false);
+    spectrumMono.setSize (1, samplesPerBlock);
     std::fill (spectrumData.begin(), spectrumData.end(), 0.0f);
 }
 
 void SnotAudioProcessor::releaseResources()
 {
     moduleGraph->reset();
-    oversamplingChain->reset();
 }
 
 //==============================================================================
@@ -65,6 +66,9 @@ void SnotAudioProcessor::processBlock (AudioBuffer<float>& buffer,
 {
     ScopedNoDenormals noDenormals;
 
+    // Every parameter read below, and in the graph, sees these values (and transport)
+    const auto& params = parameterSnapshot.capture();
+
     // Capture dry signal for wet/dry mix
     for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
         dryBuffer.copyFrom (ch, 0, buffer, ch, 0, buffer.getNumSamples());
@@ -72,19 +76,16 @@ void SnotAudioProcessor::processBlock (AudioBuffer<float>& buffer,
     // MIDI routing (FX switching, macro triggers)
     midiRouter->process (midiMessages, *macroEngine);
 
-    // Modulation tick (LFOs, envelopes, macros)
+    // Modulation tick (LFOs, envelopes), then macros on top of it
     modMatrix->process (buffer.getNumSamples());
+    macroEngine->process (params, modMatrix->getBuses());
 
-    // Oversampling upsample
-    auto oversampledBlock = oversamplingChain->processSamplesUp (
-        dsp::AudioBlock<float> (buffer));
-
-    // Process through module graph
-        // Process through module graph directly on the oversampled block
-        moduleGraph->processGraph (oversampledBlock);
+    // Process through module graph — nonlinear nodes oversample internally
+    dsp::AudioBlock<float> graphBlock (buffer);
+    moduleGraph->processGraph (graphBlock);
 
-    // Oversampling downsample
-    oversamplingChain->processSamplesDown (dsp::AudioBlock<float> (buffer));
+    // Line the dry up with the latency this block actually rendered with
+    delayDryBuffer (buffer.getNumSamples());
 
     // Auto gain compensation
     {
@@ -94,12 +95,10 @@ void SnotAudioProcessor::processBlock (AudioBuffer<float>& buffer,
     }
 
     // Master wet/dry blend
-    const float mix = apvts.getRawParameterValue (ParamID::MIX)->load();
-    applyWetDryMix (buffer, dryBuffer, mix);
+    applyWetDryMix (buffer, dryBuffer, params[ParamIndex::MIX]);
 
     // Master output gain
-    const float masterGain = apvts.getRawParameterValue (ParamID::MASTER_GAIN)->load();
-    buffer.applyGain (masterGain);
+    buffer.applyGain (params[ParamIndex::MASTER_GAIN]);
 
     // Update spectrum for visualizer
     updateSpectrum (buffer);
@@ -126,31 +125,74 @@ void SnotAudioProcessor::applyWetDryMix (AudioBuffer<float>& wet,
     }
 }
 
-void SnotAudioProcessor::updateSpectrum (const AudioBuffer<float>& buffer)
+void SnotAudioProcessor::delayDryBuffer (int numSamples)
 {
-    const int fftSize = 1 << 10;
-    if (buffer.getNumSamples() < fftSize) return;
+    const int mask   = dryDelay.getNumSamples() - 1;
+    const int target = jlimit (0, MAX_DRY_DELAY, moduleGraph->getRenderedLatencySamples());
+    const int from   = dryDelaySamples;
+    const int channels = jmin (dryBuffer.getNumChannels(), dryDelay.getNumChannels());
 
-    // Mix to mono for spectrum display
-    std::fill (fftBuffer.begin(), fftBuffer.end(), 0.0f);
-    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+    for (int ch = 0; ch < channels; ++ch)
     {
-        const float* src = buffer.getReadPointer (ch);
-        for (int i = 0; i < fftSize; ++i)
-            fftBuffer[i] += src[i];
+        float* x    = dryBuffer.getWritePointer (ch);
+        float* ring = dryDelay.getWritePointer (ch);
+
+        if (from == target)
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const int w = (dryWritePos + i) & mask;
+                ring[w] = x[i];
+                x[i]    = ring[(w - target) & mask];
+            }
+        }
+        else
+        {
+            // The latency moved (oversampling, SWC frame): fade to the new read over the block
+            const float step = 1.0f / static_cast<float> (jmax (1, numSamples));
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const int w = (dryWritePos + i) & mask;
+                ring[w] = x[i];
+                const float oldRead = ring[(w - from) & mask];
+                x[i] = oldRead + (ring[(w - target) & mask] - oldRead) * step * static_cast<float> (i + 1);
+            }
+        }
     }
-    FloatVectorOperations::multiply (fftBuffer.data(),
-                                     1.0f / buffer.getNumChannels(), fftSize);
 
-    window.multiplyWithWindowingTable (fftBuffer.data(), fftSize);
-    fft.performFrequencyOnlyForwardTransform (fftBuffer.data());
+    dryWritePos     = (dryWritePos + numSamples) & mask;
+    dryDelaySamples = target;
+}
+
+void SnotAudioProcessor::updateSpectrum (const AudioBuffer<float>& buffer)
+{
+    const int numSamples = buffer.getNumSamples();
+    const int channels   = buffer.getNumChannels();
+    if (channels == 0) return;
+
+    // Mix to mono for spectrum display
+    float* mono = spectrumMono.getWritePointer (0);
+    FloatVectorOperations::copy (mono, buffer.getReadPointer (0), numSamples);
+    for (int ch = 1; ch < channels; ++ch)
+        FloatVectorOperations::add (mono, buffer.getReadPointer (ch), numSamples);
+    FloatVectorOperations::multiply (mono, 1.0f / channels, numSamples);
+
+    const float* in[] { mono };
+    spectrumStft.process (in, nullptr, numSamples);
+}
+
+void SnotAudioProcessor::processFrame (StftEngine::Frame& frame)
+{
+    const int fftSize = frame.fftSize;
+    const float* spectrum = frame.spectra[0];
 
     // Smooth spectrum into spectrumData (log-scale bin mapping)
     for (int i = 0; i < SPECTRUM_SIZE; ++i)
     {
         const float mapped = std::pow (static_cast<float>(i) / SPECTRUM_SIZE, 2.5f);
         const int   bin    = static_cast<int> (mapped * (fftSize / 2));
-        const float level  = Decibels::gainToDecibels (fftBuffer[bin] / fftSize + 1e-9f);
+        const float mag    = std::hypot (spectrum[bin * 2], spectrum[bin * 2 + 1]);
+        const float level  = Decibels::gainToDecibels (mag / fftSize + 1e-9f);
         const float norm   = jmap (level, -80.0f, 0.0f, 0.0f, 1.0f);
         // Smooth with previous
         spectrumData[i] = spectrumData[i] * 0.85f + jlimit (0.0f, 1.0f, norm) * 0.15f;
@@ -158,27 +200,11 @@ void SnotAudioProcessor::updateSpectrum (const AudioBuffer<float>& buffer)
     spectrumReady.store (true, std::memory_order_release);
 }
 
-//==============================================================================
-void SnotAudioProcessor::parameterChanged (const String& paramID, float newValue)
-{
-    if (paramID == ParamID::OVERSAMPLE)
-        updateOversamplingFromParam (newValue);
-}
-
-void SnotAudioProcessor::updateOversamplingFromParam (float value)
-{
-    const int factors[] = { 1, 2, 4, 8 };
-    const int idx = jlimit (0, 3, static_cast<int> (value));
-    oversamplingChain->setFactor (factors[idx]);
-    oversampleFactor.store (factors[idx]);
-    setLatencySamples (static_cast<int> (oversamplingChain->getLatencyInSamples()));
-}
-
 //==============================================================================
 double SnotAudioProcessor::getTailLengthSeconds() const
 {
-    // Portal reverb can tail for up to 30 seconds
-    return 30.0;
+    // The graph sums node tails along its longest path (reverb decay, delay feedback)
+    return moduleGraph->getTailLengthSeconds();
 }
 
 //==============================================================================
@@ -225,118 +251,31 @@ void SnotAudioProcessor::changeProgramName (int i, const String& n) { presetMana
 //==============================================================================
 AudioProcessorValueTreeState::ParameterLayout SnotAudioProcessor::createParameterLayout()
 {
+    // Generated from ParamIndex::table, in index order
     std::vector<std::unique_ptr<RangedAudioParameter>> params;
 
-    auto addFloat = [&](const char* id, const char* name,
-                        float min, float max, float def,
-                        float skew = 1.0f)
-    {
-        NormalisableRange<float> range (min, max);
-        range.skew = skew;
-        params.push_back (std::make_unique<AudioParameterFloat> (
-            ParameterID {id, 1}, name, range, def));
-    };
-
-    auto addBool = [&](const char* id, const char* name, bool def)
+    for (const auto& spec : ParamIndex::table)
     {
-        params.push_back (std::make_unique<AudioParameterBool> (
-            ParameterID {id, 1}, name, def));
-    };
-
-    auto addChoice = [&](const char* id, const char* name,
-                         StringArray choices, int def)
-    {
-        params.push_back (std::make_unique<AudioParameterChoice> (
-            ParameterID {id, 1}, name, choices, def));
-    };
-
-    // Master
-    addFloat (ParamID::MASTER_GAIN, "Master Gain", 0.0f, 2.0f, 1.0f);
-    addFloat (ParamID::MIX,         "Mix",         0.0f, 1.0f, 1.0f);
-    addChoice(ParamID::OVERSAMPLE,  "Oversampling",
-              {"1x", "2x", "4x", "8x"}, 1);
-
-    // Macros
-    for (int i = 0; i < 8; ++i)
-    {
-        const String id   = "macro_" + String (i + 1);
-        const String name = "Macro " + String (i + 1);
-        addFloat (id.toRawUTF8(), name.toRawUTF8(), 0.0f, 1.0f, 0.0f);
+        const ParameterID id { spec.id, 1 };
+        switch (spec.kind)
+        {
+            case ParamSpec::floatParam:
+            {
+                NormalisableRange<float> range (spec.min, spec.max);
+                range.skew = spec.skew;
+                params.push_back (std::make_unique<AudioParameterFloat> (id, spec.name, range, spec.def));
+                break;
+            }
+            case ParamSpec::boolParam:
+                params.push_back (std::make_unique<AudioParameterBool> (id, spec.name, spec.def >= 0.5f));
+                break;
+            case ParamSpec::choiceParam:
+                params.push_back (std::make_unique<AudioParameterChoice> (
+                    id, spec.name, StringArray::fromTokens (spec.choices, "|", ""), static_cast<int> (spec.def)));
+                break;
+        }
     }
 
-    // Spectral Warp Chorus
-    addFloat  (ParamID::SWC_DEPTH,  "SWC Depth",  0.0f, 1.0f,   0.5f);
-    addFloat  (ParamID::SWC_RATE,   "SWC Rate",   0.01f, 10.0f, 0.5f, 0.4f);
-    addFloat  (ParamID::SWC_VOICES, "SWC Voices", 1.0f, 8.0f,   4.0f);
-    addFloat  (ParamID::SWC_WARP,   "SWC Warp",   0.0f, 1.0f,   0.3f);
-    addFloat  (ParamID::SWC_MIX,    "SWC Mix",    0.0f, 1.0f,   0.6f);
-    addBool   (ParamID::SWC_ENABLED,"SWC Enable",  true);
-
-    // Portal Reverb
-    addFloat (ParamID::PR_SIZE,    "Reverb Size",    0.0f, 1.0f, 0.7f);
-    addFloat (ParamID::PR_DECAY,   "Reverb Decay",   0.1f, 60.0f, 8.0f, 0.3f);
-    addFloat (ParamID::PR_DRIFT,   "Reverb Drift",   0.0f, 1.0f, 0.4f);
-    addFloat (ParamID::PR_SHIMMER, "Reverb Shimmer", 0.0f, 1.0f, 0.2f);
-    addFloat (ParamID::PR_DAMPING, "Reverb Damping", 0.0f, 1.0f, 0.3f);
-    addFloat (ParamID::PR_MIX,     "Reverb Mix",     0.0f, 1.0f, 0.4f);
-    addBool  (ParamID::PR_ENABLED, "Reverb Enable",  true);
-
-    // Pitch Smear Delay
-    addFloat (ParamID::PSD_TIME,     "Delay Time",     0.01f, 4.0f, 0.25f, 0.4f);
-    addFloat (ParamID::PSD_FEEDBACK, "Delay Feedback", 0.0f,  0.99f, 0.4f);
-    addFloat (ParamID::PSD_SMEAR,    "Delay Smear",    0.0f,  1.0f, 0.3f);
-    addBool  (ParamID::PSD_SYNC,     "Delay Sync",     true);
-    addFloat (ParamID::PSD_MIX,      "Delay Mix",      0.0f,  1.0f, 0.4f);
-    addBool  (ParamID::PSD_ENABLED,  "Delay Enable",   true);
-
-    // 808 Inflator
-    addFloat (ParamID::H8_DRIVE,  "808 Drive",  0.0f, 1.0f, 0.3f);
-    addFloat (ParamID::H8_PUNCH,  "808 Punch",  0.0f, 1.0f, 0.5f);
-    addFloat (ParamID::H8_BLOOM,  "808 Bloom",  0.0f, 1.0f, 0.2f);
-    addFloat (ParamID::H8_TUNE,   "808 Tune",   -24.0f, 24.0f, 0.0f);
-    addFloat (ParamID::H8_MIX,    "808 Mix",    0.0f, 1.0f, 0.8f);
-    addBool  (ParamID::H8_ENABLED,"808 Enable", false);
-
-    // Gravity Filter
-    addFloat  (ParamID::GF_FREQ,   "Filter Freq",  20.0f, 20000.0f, 2000.0f, 0.25f);
-    addFloat  (ParamID::GF_RESO,   "Filter Reso",  0.0f, 1.0f, 0.3f);
-    addFloat  (ParamID::GF_CURVE,  "Filter Curve", -1.0f, 1.0f, 0.0f);
-    addChoice (ParamID::GF_MODE,   "Filter Mode",
-               {"LP", "HP", "BP", "Notch", "Gravity"}, 4);
-    addBool   (ParamID::GF_ENABLED,"Filter Enable", true);
-
-    // Plasma Distortion
-    addFloat (ParamID::PD_DRIVE,    "Plasma Drive",     0.0f, 1.0f, 0.4f);
-    addFloat (ParamID::PD_CHARACTER,"Plasma Character", 0.0f, 1.0f, 0.5f);
-    addFloat (ParamID::PD_BIAS,     "Plasma Bias",      -1.0f, 1.0f, 0.0f);
-    addFloat (ParamID::PD_MIX,      "Plasma Mix",       0.0f, 1.0f, 0.5f);
-    addBool  (ParamID::PD_ENABLED,  "Plasma Enable",    false);
-
-    // Stereo Neural Motion
-    addFloat (ParamID::SNM_WIDTH,  "SNM Width",  0.0f, 2.0f, 1.0f);
-    addFloat (ParamID::SNM_MOTION, "SNM Motion", 0.0f, 1.0f, 0.3f);
-    addFloat (ParamID::SNM_RATE,   "SNM Rate",   0.01f, 4.0f, 0.2f, 0.4f);
-    addBool  (ParamID::SNM_ENABLED,"SNM Enable", true);
-
-    // Texture Generator
-    addFloat (ParamID::TG_DENSITY,   "Texture Density",   0.0f, 1.0f, 0.2f);
-    addFloat (ParamID::TG_CHARACTER, "Texture Character", 0.0f, 1.0f, 0.5f);
-    addFloat (ParamID::TG_MIX,       "Texture Mix",       0.0f, 1.0f, 0.15f);
-    addBool  (ParamID::TG_ENABLED,   "Texture Enable",    false);
-
-    // Freeze Capture
-    addBool  (ParamID::FC_FREEZE,  "Freeze",       false);
-    addFloat (ParamID::FC_SIZE,    "Freeze Size",  0.01f, 4.0f, 0.5f, 0.5f);
-    addFloat (ParamID::FC_PITCH,   "Freeze Pitch", -24.0f, 24.0f, 0.0f);
-    addFloat (ParamID::FC_MIX,     "Freeze Mix",   0.0f, 1.0f, 1.0f);
-    addBool  (ParamID::FC_ENABLED, "Freeze Enable",false);
-
-    // Mutation Engine
-    addFloat (ParamID::ME_AMOUNT,   "Mutation Amount",   0.0f, 1.0f, 0.2f);
-    addFloat (ParamID::ME_RATE,     "Mutation Rate",     0.01f, 8.0f, 0.5f, 0.4f);
-    addFloat (ParamID::ME_CHARACTER,"Mutation Character",0.0f, 1.0f, 0.5f);
-    addBool  (ParamID::ME_ENABLED,  "Mutation Enable",   false);
-
     return { params.begin(), params.end() };
 }
 
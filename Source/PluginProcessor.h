@@ -6,13 +6,16 @@
 #include "dsp/OversamplingChain.h"
 #include "dsp/GainStager.h"
 #include "dsp/MidiRouter.h"
+#include "dsp/StftEngine.h"
+#include "dsp/ParameterWriteQueue.h"
+#include "dsp/ParameterSnapshot.h"
 #include "preset/PresetManager.h"
 
 //==============================================================================
 // ParamID namespace lives in ParamIDs.h (included via JuceHeader.h)
 //==============================================================================
 class SnotAudioProcessor : public juce::AudioProcessor,
-                           public juce::AudioProcessorValueTreeState::Listener
+                           private StftEngine::Subscriber
 {
 public:
     SnotAudioProcessor();
@@ -46,10 +49,6 @@ public:
     void getStateInformation (juce::MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
 
-    //==============================================================================
-    // Parameter change callback
-    void parameterChanged (const juce::String& paramID, float newValue) override;
-
     //==============================================================================
     // Public accessors for editor
     juce::AudioProcessorValueTreeState& getAPVTS() { return apvts; }
@@ -68,29 +67,36 @@ private:
 
     juce::AudioProcessorValueTreeState apvts;
 
+    // Every parameter's value, gathered once per block for the audio thread
+    ParameterSnapshot parameterSnapshot;
+
+    // Audio-thread parameter writes (MIDI) reach the host through here
+    std::unique_ptr<ParameterWriteQueue> paramWriteQueue;
+
     std::unique_ptr<ModuleGraph>       moduleGraph;
     std::unique_ptr<MacroEngine>       macroEngine;
     std::unique_ptr<ModulationMatrix>  modMatrix;
-    std::unique_ptr<OversamplingChain> oversamplingChain;
     std::unique_ptr<GainStager>        gainStager;
     std::unique_ptr<MidiRouter>        midiRouter;
     std::unique_ptr<PresetManager>     presetManager;
 
-    // Spectrum analyzer (FFT)
-    juce::dsp::FFT fft;
-    juce::dsp::WindowingFunction<float> window;
-    std::vector<float> fftBuffer;
+    // Spectrum analyzer: a mono mix of the output through a shared STFT
+    static constexpr int SPECTRUM_FFT_ORDER = 10; // 1024-point
+    StftEngine spectrumStft;
+    juce::AudioBuffer<float> spectrumMono;
     std::array<float, SPECTRUM_SIZE> spectrumData{};
     std::atomic<bool> spectrumReady { false };
 
-    // Wet/dry mix buffer
-    juce::AudioBuffer<float> dryBuffer;
+    // Wet/dry mix buffer, delayed by the latency the graph rendered with so Mix < 1 doesn't comb-filter
+    static constexpr int MAX_DRY_DELAY = 1 << 14; // several SWC frames plus every oversampler
+    juce::AudioBuffer<float> dryBuffer, dryDelay;
+    int dryWritePos     { 0 };
+    int dryDelaySamples { 0 };
 
-    // Current oversampling factor
-    std::atomic<int> oversampleFactor { 1 };
+    void delayDryBuffer (int numSamples);
 
-    void updateOversamplingFromParam (float value);
     void updateSpectrum (const juce::AudioBuffer<float>& buffer);
+    void processFrame (StftEngine::Frame& frame) override;
     void applyWetDryMix (juce::AudioBuffer<float>& wet,
                          const juce::AudioBuffer<float>& dry, float mix);
 
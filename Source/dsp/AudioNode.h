@@ -1,5 +1,54 @@
 #pragma once
 #include <JuceHeader.h>
+#include "NodeProfiler.h"
+#include "ModulationBuses.h"
+#include "ParameterSmoother.h"
+#include "EqualPowerMix.h"
+#include "StereoLanes.h"
+
+//==============================================================================
+/**
+ * NodeContext — one block as a node renders it: raw channel spans plus the
+ * block's parameter snapshot, modulation and transport, any of which may be
+ * nullptr outside a graph. Channels never overlap, so kernels take them as
+ * SNOT_RESTRICT pointers; linked L/R kernels use StereoLanes on top.
+ */
+struct NodeContext
+{
+    static constexpr int MAX_CHANNELS = 8;
+
+    float* const*          channels    { nullptr };
+    int                    numChannels { 0 };
+    int                    numSamples  { 0 };
+    const ParameterValues* parameters  { nullptr };
+    const ModulationBuses* modulation  { nullptr };
+    const TransportInfo*   transport   { nullptr };
+
+    float* channel (int ch) const noexcept
+    {
+        jassert (ch >= 0 && ch < numChannels);
+        return channels[ch];
+    }
+
+    bool isStereo() const noexcept { return numChannels > 1; }
+
+    /** A parameter's raw value in this block's snapshot. */
+    float getParameter (ParamIndex::Index index) const noexcept
+    {
+        jassert (parameters != nullptr);
+        return (*parameters)[index];
+    }
+
+    /** Fill `out` with an AudioBlock's channel pointers; returns how many. */
+    static int gatherChannels (const juce::dsp::AudioBlock<float>& block, float** out) noexcept
+    {
+        jassert (block.getNumChannels() <= static_cast<size_t> (MAX_CHANNELS));
+        const int n = juce::jmin (MAX_CHANNELS, static_cast<int> (block.getNumChannels()));
+        for (int ch = 0; ch < n; ++ch)
+            out[ch] = block.getChannelPointer (static_cast<size_t> (ch));
+        return n;
+    }
+};
 
 //==============================================================================
 /**
@@ -7,13 +56,30 @@
  *
  * Subclasses implement:
  *   - prepare()   — allocate resources for given spec
- *   - process()   — audio callback (called on audio thread)
+ *   - render()    — audio callback (called on audio thread)
  *   - reset()     — clear state
  *   - getName()   — human-readable name
  *   - getType()   — serialization type string
  *
- * Parameter access is via APVTS — nodes cache raw pointers to
- * std::atomic<float> for zero-overhead per-sample reads.
+ * Optionally:
+ *   - getTailLengthSeconds() — how long output lingers after input stops
+ *   - canSleep()  — false while the node sounds without input
+ *   - getOversamplingFactor() — > 1 for nonlinear nodes that alias
+ *   - getLatencySamples() — processing delay the host must compensate
+ *     (and getBlockLatencySamples(), when it follows a parameter)
+ *
+ * render() receives the block as a NodeContext of raw channel spans.
+ * process (AudioBlock&) remains as an adapter for callers that hold a
+ * block; StepRunner calls render() directly.
+ *
+ * Parameters are read on the audio thread from the context's
+ * ParameterValues snapshot, by ParamIndex. Parameters that take modulation
+ * are read through ModulatedParameter, which adds the ModulationMatrix's
+ * offset lane without touching the host value. Message-thread queries
+ * (latency, the processor's tail) read the APVTS directly.
+ * Parameters that shape the audio per sample go through the node's
+ * ParameterSmoother, which turns automation steps into ramps. Dry/wet
+ * controls blend through an EqualPowerMix.
  */
 class AudioNode
 {
@@ -22,16 +88,96 @@ public:
 
     //==============================================================================
     virtual void prepare (const juce::dsp::ProcessSpec& spec) = 0;
-    virtual void process (juce::dsp::AudioBlock<float>& block) = 0;
+    virtual void render (const NodeContext& context) noexcept = 0;
     virtual void reset() = 0;
 
+    /** Render an AudioBlock in place. */
+    void process (juce::dsp::AudioBlock<float>& block) noexcept
+    {
+        float* channels[NodeContext::MAX_CHANNELS] {};
+        const int numChannels = NodeContext::gatherChannels (block, channels);
+        render (makeContext (channels, numChannels, static_cast<int> (block.getNumSamples())));
+    }
+
+    /** The context for one block over the given channels, with this node's block sources. */
+    NodeContext makeContext (float* const* channels, int numChannels, int numSamples) const noexcept
+    {
+        return { channels, numChannels, numSamples, parameters, modulation, transport };
+    }
+
     virtual juce::String getName() const = 0;
     virtual juce::String getType() const = 0;
 
+    //==============================================================================
+    /**
+     * ModuleGraph stops calling render() once a node's input has been silent
+     * for longer than its tail, and resumes on the first non-silent block.
+     * Generators and frozen loops must return false from canSleep().
+     *
+     * Both are evaluated for the given parameter values and modulation: the
+     * block's snapshot on the audio thread (getBlockTailSeconds()), or the
+     * APVTS when values is nullptr, for message-thread callers.
+     */
+    virtual double getTailLengthSeconds (const ParameterValues* values, const ModulationBuses* buses) const
+    {
+        juce::ignoreUnused (values, buses);
+        return 0.0;
+    }
+
+    virtual bool canSleep (const ParameterValues* values) const
+    {
+        juce::ignoreUnused (values);
+        return true;
+    }
+
+    /** Audio thread: the tail and sleep permission for this block's snapshot and modulation. */
+    double getBlockTailSeconds() const { return getTailLengthSeconds (parameters, modulation); }
+    bool   canSleepThisBlock() const   { return canSleep (parameters); }
+
+    /**
+     * Oversampling this node benefits from (1, 2, 4 or 8). Nonlinear nodes
+     * return > 1 and are prepared and run at that multiple of the base rate,
+     * capped by the global Oversampling setting; linear nodes keep the default.
+     */
+    virtual int getOversamplingFactor() const { return 1; }
+
+    /**
+     * Delay between this node's input and output, in samples at the rate it
+     * was prepared with. Nodes that delay their dry path to line up with a
+     * latent wet path report the total. ModuleGraph polls this from the
+     * message thread and forwards changes to the host.
+     */
+    virtual int getLatencySamples() const { return 0; }
+
+    /**
+     * Audio thread, after render(): the delay the block just rendered
+     * actually carried. Nodes whose latency follows a parameter override
+     * this, since the APVTS that getLatencySamples() reads runs ahead of
+     * the audio. ModuleGraph sums it every block for the master dry path.
+     */
+    virtual int getBlockLatencySamples() const { return getLatencySamples(); }
+
     //==============================================================================
     bool isEnabled() const noexcept { return enabled.load (std::memory_order_relaxed); }
     void setEnabled (bool e) noexcept { enabled.store (e, std::memory_order_relaxed); }
 
+    /**
+     * Set by ModuleGraph when the node joins it: the processor's per-block
+     * parameter snapshot, modulation and transport, any of which may be
+     * nullptr. Every NodeContext the node renders carries them.
+     */
+    void setBlockSources (const ParameterValues* values, const ModulationBuses* buses,
+                          const TransportInfo* transportInfo) noexcept
+    {
+        parameters = values;
+        modulation = buses;
+        transport  = transportInfo;
+    }
+
+    /** Timing counters filled in by ModuleGraph, read by the editor. */
+    NodeProfileStats&       getProfileStats()       noexcept { return profileStats; }
+    const NodeProfileStats& getProfileStats() const noexcept { return profileStats; }
+
     //==============================================================================
     /** Called by ModuleGraph::morphTo — lerp all parameters toward target. */
     virtual void morphFrom (const AudioNode& target, float t)
@@ -54,8 +200,19 @@ public:
     juce::Point<float> canvasPosition { 0.0f, 0.0f };
     juce::Colour       orb_colour     { 0xff00ffcc };
 
+    /** Render-thread bookkeeping owned by ModuleGraph: silent input run length. */
+    juce::int64 silentInputSamples { 0 };
+    double      silentRunTail      { 0.0 }; // longest tail reported since input was last heard
+
 protected:
-    std::atomic<bool> enabled { true };
+    std::atomic<bool>      enabled    { true };
+    NodeProfileStats       profileStats;
+
+    /** Audio thread: not bypassed in the graph and the node's own enable switch is on. */
+    bool isActive (const NodeContext& context, ParamIndex::Index enableParam) const noexcept
+    {
+        return isEnabled() && context.getParameter (enableParam) >= 0.5f;
+    }
 
     //==============================================================================
     /** Utility: soft clip to prevent harsh output. */
@@ -72,10 +229,8 @@ protected:
         return a + t * (b - a);
     }
 
-    /** Utility: equal-power crossfade. */
-    static inline float eqpCrossfade (float dry, float wet, float mix) noexcept
-    {
-        const float angle = mix * juce::MathConstants<float>::halfPi;
-        return dry * std::cos (angle) + wet * std::sin (angle);
-    }
+private:
+    const ParameterValues* parameters { nullptr };
+    const ModulationBuses* modulation { nullptr };
+    const TransportInfo*   transport  { nullptr };
 };
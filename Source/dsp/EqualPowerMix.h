@@ -0,0 +1,134 @@
+#pragma once
+#include <JuceHeader.h>
+#include "ParameterSmoother.h"
+#include "SimdDispatch.h"
+
+//==============================================================================
+/**
+ * EqualPowerMix — the dry/wet stage shared by every node with a mix control.
+ *
+ * The cos/sin gains are worked out once per block, not once per sample
+ * and channel:
+ *   - A steady mix costs nothing until it changes. Then its two gains are
+ *     computed and the gain buffers refilled once.
+ *   - A ramping mix (from the node's ParameterSmoother) is evaluated every
+ *     SEGMENT samples. The gains are interpolated linearly in between, which
+ *     stays within a hair of equal power at any ramp speed the smoother
+ *     produces.
+ *
+ * Whole buffers are blended with vector operations. Kernels that make their
+ * wet signal one sample at a time blend inline with mixSample():
+ *
+ *     mixer.update (smoother, mixSlot, numSamples);
+ *     mixer.apply (out, wet, numSamples);         // or, per sample:
+ *     x[s] = mixer.mixSample (x[s], wet, s);
+ */
+class EqualPowerMix
+{
+public:
+    static constexpr int SEGMENT = 32;
+
+    EqualPowerMix() = default;
+
+    /** Message thread: size the gain buffers for blocks up to maxBlockSize. */
+    void prepare (int maxBlockSize)
+    {
+        maxBlock = juce::jmax (1, maxBlockSize);
+        dryGains.assign (static_cast<size_t> (maxBlock), 1.0f);
+        wetGains.assign (static_cast<size_t> (maxBlock), 0.0f);
+        reset();
+    }
+
+    /** The next update() starts from its mix without a ramp. */
+    void reset() noexcept { snapToTarget = true; }
+
+    //==============================================================================
+    /** Audio thread, once per block: gains for the block from a smoother's mix slot (0 = dry, 1 = wet). */
+    void update (const ParameterSmoother& smoother, int mixSlot, int numSamples) noexcept
+    {
+        jassert (numSamples <= maxBlock);
+        numSamples = juce::jmin (numSamples, maxBlock);
+
+        if (smoother.isConstant (mixSlot))
+        {
+            const float mix = smoother.getValue (mixSlot);
+            if (snapToTarget || ! constant || mix != filledMix)
+            {
+                dryGain = std::cos (mix * juce::MathConstants<float>::halfPi);
+                wetGain = std::sin (mix * juce::MathConstants<float>::halfPi);
+                juce::FloatVectorOperations::fill (dryGains.data(), dryGain, maxBlock);
+                juce::FloatVectorOperations::fill (wetGains.data(), wetGain, maxBlock);
+                filledMix = mix;
+            }
+            constant     = true;
+            snapToTarget = false;
+            return;
+        }
+
+        const float* mix = smoother.get (mixSlot);
+        if (snapToTarget)
+        {
+            dryGain = std::cos (mix[0] * juce::MathConstants<float>::halfPi);
+            wetGain = std::sin (mix[0] * juce::MathConstants<float>::halfPi);
+        }
+
+        // Exact gains at each segment's last sample, linear in between
+        float* dry = dryGains.data();
+        float* wet = wetGains.data();
+        for (int start = 0; start < numSamples; start += SEGMENT)
+        {
+            const int   len   = juce::jmin (SEGMENT, numSamples - start);
+            const float angle = mix[start + len - 1] * juce::MathConstants<float>::halfPi;
+            const float dryEnd = std::cos (angle);
+            const float wetEnd = std::sin (angle);
+            const float dryStep = (dryEnd - dryGain) / static_cast<float> (len);
+            const float wetStep = (wetEnd - wetGain) / static_cast<float> (len);
+
+            for (int i = 0; i < len; ++i)
+            {
+                dry[start + i] = dryGain + dryStep * static_cast<float> (i + 1);
+                wet[start + i] = wetGain + wetStep * static_cast<float> (i + 1);
+            }
+
+            dryGain = dryEnd;
+            wetGain = wetEnd;
+        }
+
+        constant     = false;
+        snapToTarget = false;
+    }
+
+    //==============================================================================
+    /** Audio thread: io = io · dry gain + wet · wet gain over the block. */
+    void apply (float* SNOT_RESTRICT io, const float* SNOT_RESTRICT wet, int numSamples) const noexcept
+    {
+        using FVO = juce::FloatVectorOperations;
+        if (constant)
+        {
+            FVO::multiply (io, dryGain, numSamples);
+            FVO::addWithMultiply (io, wet, wetGain, numSamples);
+        }
+        else
+        {
+            FVO::multiply (io, dryGains.data(), numSamples);
+            FVO::addWithMultiply (io, wet, wetGains.data(), numSamples);
+        }
+    }
+
+    /** Audio thread: one sample of the blend, for kernels that produce wet inline. */
+    float mixSample (float dry, float wet, int sample) const noexcept
+    {
+        return dry * dryGains[static_cast<size_t> (sample)] + wet * wetGains[static_cast<size_t> (sample)];
+    }
+
+private:
+    std::vector<float> dryGains, wetGains; // maxBlock each
+    int   maxBlock     { 0 };
+    float dryGain      { 1.0f };           // at the end of the last block
+    float wetGain      { 0.0f };
+    float filledMix    { 0.0f };
+    bool  constant     { true };
+    bool  snapToTarget { true };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (EqualPowerMix)
+};
@@ -0,0 +1,354 @@
+#pragma once
+#include <JuceHeader.h>
+#if JUCE_INTEL
+ #include <emmintrin.h>
+#endif
+
+/**
+ * SNOT_USE_JUCE_FFT — route every spectral transform through juce::dsp::FFT
+ * instead of the bundled real FFT. Off by default.
+ */
+#ifndef SNOT_USE_JUCE_FFT
+ #define SNOT_USE_JUCE_FFT 0
+#endif
+
+//==============================================================================
+/**
+ * FftBackend
+ *
+ * A real-only FFT of one size, in juce::dsp::FFT's conventions so either
+ * backend drops into the same code:
+ *
+ *   - data holds 2N floats.
+ *   - forward() reads N real samples and writes bins 0 … N/2 as
+ *     interleaved complex.
+ *   - inverse() reads those bins and writes N real samples, scaled by 1/N.
+ *
+ * Both calls are const and keep no per-call state, so one backend can be
+ * shared between threads.
+ */
+class FftBackend
+{
+public:
+    enum class Kind { bundled, juce };
+
+    virtual ~FftBackend() = default;
+
+    virtual void forward (float* data) const noexcept = 0;
+    virtual void inverse (float* data) const noexcept = 0;
+    virtual Kind getKind() const noexcept = 0;
+
+    /**
+     * Two channels at once, each buffer laid out as for forward()/inverse().
+     * Backends that can pack both into one complex transform override these.
+     */
+    virtual void forwardStereo (float* left, float* right) const noexcept { forward (left); forward (right); }
+    virtual void inverseStereo (float* left, float* right) const noexcept { inverse (left); inverse (right); }
+
+    int getSize() const noexcept { return size; }
+
+    /** The build's default backend for 2^order points; JUCE where the bundled one cannot run. */
+    static std::unique_ptr<FftBackend> create (int order);
+
+    /** A specific backend, e.g. for benchmarking. */
+    static std::unique_ptr<FftBackend> create (int order, Kind kind);
+
+protected:
+    explicit FftBackend (int order) : size (1 << order) {}
+
+    const int size;
+};
+
+//==============================================================================
+/** juce::dsp::FFT — vendor-accelerated where JUCE has a vendor engine. */
+class JuceFftBackend final : public FftBackend
+{
+public:
+    explicit JuceFftBackend (int order) : FftBackend (order), fft (order) {}
+
+    void forward (float* data) const noexcept override { fft.performRealOnlyForwardTransform (data, true); }
+    void inverse (float* data) const noexcept override { fft.performRealOnlyInverseTransform (data); }
+    Kind getKind() const noexcept override { return Kind::juce; }
+
+private:
+    juce::dsp::FFT fft;
+};
+
+//==============================================================================
+/**
+ * SplitRealFft — the bundled backend.
+ *
+ * Packs N real samples as N/2 complex ones (even + i·odd), runs a radix-2
+ * decimation-in-frequency FFT on split-complex storage, and untangles the
+ * real spectrum with one twiddle pass. Split storage keeps every butterfly
+ * stage a run of contiguous 4-wide vector operations (SSE2, or plain
+ * loops the compiler vectorises elsewhere); per-stage twiddle tables are
+ * contiguous for the same reason. The DIF output stays bit-reversed and
+ * the untangling pass reads through a bit-reversal table, so no separate
+ * permutation pass is needed.
+ *
+ * The stereo calls pack L + i·R into one N-point complex transform and
+ * separate the channels by conjugate symmetry — one transform per frame
+ * instead of two. The N/2-point tables are a suffix of the N-point ones,
+ * so both paths share them.
+ *
+ * The upper half of the caller's 2N-float buffer is the complex work
+ * area, so the transform needs no scratch of its own.
+ */
+class SplitRealFft final : public FftBackend
+{
+public:
+    static constexpr int MIN_ORDER = 4;
+
+    explicit SplitRealFft (int order)
+        : FftBackend (order), half (size / 2)
+    {
+        jassert (order >= MIN_ORDER);
+
+        // Stage twiddles e^{-2πij/len}, j < len/2, for len = N, N/2, …, 8
+        for (int len = size; len >= 8; len >>= 1)
+            for (int j = 0; j < len / 2; ++j)
+            {
+                const double a = -juce::MathConstants<double>::twoPi * j / len;
+                twiddleRe.push_back (static_cast<float> (std::cos (a)));
+                twiddleIm.push_back (static_cast<float> (std::sin (a)));
+            }
+
+        // Untangling twiddles e^{-2πik/N}, k ≤ N/2
+        for (int k = 0; k <= half; ++k)
+        {
+            const double a = -juce::MathConstants<double>::twoPi * k / size;
+            untangleRe.push_back (static_cast<float> (std::cos (a)));
+            untangleIm.push_back (static_cast<float> (std::sin (a)));
+        }
+
+        // N-point bit reversal; the N/2-point one is every second entry
+        bitReversed.resize (static_cast<size_t> (size));
+        for (int i = 0; i < size; ++i)
+        {
+            int r = 0;
+            for (int b = 0; b < order; ++b)
+                r |= ((i >> b) & 1) << (order - 1 - b);
+            bitReversed[static_cast<size_t> (i)] = r;
+        }
+    }
+
+    //==============================================================================
+    void forward (float* data) const noexcept override
+    {
+        float* re = data + size;
+        float* im = re + half;
+        const int* br = bitReversed.data();
+
+        // z[n] = x[2n] + i·x[2n+1]
+        for (int n = 0; n < half; ++n)
+        {
+            re[n] = data[2 * n];
+            im[n] = data[2 * n + 1];
+        }
+
+        transform (re, im, half);
+
+        // X[k] = E[k] + e^{-2πik/N} · O[k], with E and O untangled from Z[k], Z[M−k]
+        const float dc = re[0] + im[0], nyquist = re[0] - im[0];
+        for (int k = 1; k < half; ++k)
+        {
+            const int a = br[2 * k], b = br[2 * (half - k)];
+            const float eRe = 0.5f * (re[a] + re[b]), eIm = 0.5f * (im[a] - im[b]);
+            const float oRe = 0.5f * (im[a] + im[b]), oIm = 0.5f * (re[b] - re[a]);
+            const float wRe = untangleRe[static_cast<size_t> (k)], wIm = untangleIm[static_cast<size_t> (k)];
+            data[2 * k]     = eRe + wRe * oRe - wIm * oIm;
+            data[2 * k + 1] = eIm + wRe * oIm + wIm * oRe;
+        }
+
+        // Written last: bin N/2 lands on the work area
+        data[0] = dc;     data[1] = 0.0f;
+        data[size] = nyquist; data[size + 1] = 0.0f;
+    }
+
+    void inverse (float* data) const noexcept override
+    {
+        float* re = data + size;
+        float* im = re + half;
+        const int* br = bitReversed.data();
+        const float scale = 1.0f / static_cast<float> (half);
+
+        // Bin N/2 shares storage with Z[0], so take it first
+        const float dc = data[0], nyquist = data[size];
+
+        // Z[k] = E[k] + i·O[k], conjugated and scaled so a forward pass inverts
+        re[0] = 0.5f * (dc + nyquist) * scale;
+        im[0] = -0.5f * (dc - nyquist) * scale;
+        for (int k = 1; k < half; ++k)
+        {
+            const float xRe = data[2 * k],                xIm = data[2 * k + 1];
+            const float yRe = data[2 * (half - k)],       yIm = -data[2 * (half - k) + 1];
+            const float eRe = 0.5f * (xRe + yRe), eIm = 0.5f * (xIm + yIm);
+            const float dRe = 0.5f * (xRe - yRe), dIm = 0.5f * (xIm - yIm);
+            const float wRe = untangleRe[static_cast<size_t> (k)], wIm = -untangleIm[static_cast<size_t> (k)];
+            const float oRe = dRe * wRe - dIm * wIm, oIm = dRe * wIm + dIm * wRe;
+            re[k] =  (eRe - oIm) * scale;
+            im[k] = -(eIm + oRe) * scale;
+        }
+
+        transform (re, im, half);
+
+        for (int n = 0; n < half; ++n)
+        {
+            data[2 * n]     =  re[br[2 * n]];
+            data[2 * n + 1] = -im[br[2 * n]];
+        }
+    }
+
+    Kind getKind() const noexcept override { return Kind::bundled; }
+
+    //==============================================================================
+    void forwardStereo (float* left, float* right) const noexcept override
+    {
+        float* re = left + size;
+        float* im = right + size;
+        const int* br = bitReversed.data();
+
+        // z = L + i·R
+        std::copy (left,  left + size,  re);
+        std::copy (right, right + size, im);
+
+        transform (re, im, size);
+
+        // L[k] = (Z[k] + conj Z[N−k]) / 2,  R[k] = (Z[k] − conj Z[N−k]) / 2i
+        const float dcL = re[0], dcR = im[0];
+        const float nyL = re[br[half]], nyR = im[br[half]];
+        for (int k = 1; k < half; ++k)
+        {
+            const int a = br[k], b = br[size - k];
+            left[2 * k]      = 0.5f * (re[a] + re[b]);
+            left[2 * k + 1]  = 0.5f * (im[a] - im[b]);
+            right[2 * k]     = 0.5f * (im[a] + im[b]);
+            right[2 * k + 1] = 0.5f * (re[b] - re[a]);
+        }
+
+        // Written last: bin N/2 lands on the work area
+        left[0]  = dcL; left[1]  = 0.0f; left[size]  = nyL; left[size + 1]  = 0.0f;
+        right[0] = dcR; right[1] = 0.0f; right[size] = nyR; right[size + 1] = 0.0f;
+    }
+
+    void inverseStereo (float* left, float* right) const noexcept override
+    {
+        float* re = left + size;
+        float* im = right + size;
+        const int* br = bitReversed.data();
+        const float scale = 1.0f / static_cast<float> (size);
+
+        // Bin N/2 shares storage with Z[0] and Z[1], so take it first
+        const float nyL = left[size], nyR = right[size];
+
+        // Z[j] = L[j] + i·R[j] over the full circle, conjugated and scaled
+        // so a forward pass inverts; bins above N/2 mirror as conjugates
+        const auto pack = [&] (int j, float lRe, float lIm, float rRe, float rIm) noexcept
+        {
+            re[j] =  (lRe - rIm) * scale;
+            im[j] = -(lIm + rRe) * scale;
+        };
+
+        pack (0, left[0], 0.0f, right[0], 0.0f);
+        for (int k = 1; k < half; ++k)
+        {
+            const float lRe = left[2 * k],  lIm = left[2 * k + 1];
+            const float rRe = right[2 * k], rIm = right[2 * k + 1];
+            pack (k,        lRe,  lIm, rRe,  rIm);
+            pack (size - k, lRe, -lIm, rRe, -rIm);
+        }
+        pack (half, nyL, 0.0f, nyR, 0.0f);
+
+        transform (re, im, size);
+
+        for (int n = 0; n < size; ++n)
+        {
+            left[n]  =  re[br[n]];
+            right[n] = -im[br[n]];
+        }
+    }
+
+private:
+    //==============================================================================
+    /** In-place radix-2 DIF FFT of n (N or N/2) points; output in bit-reversed order. */
+    void transform (float* re, float* im, int n) const noexcept
+    {
+        // Tables run from the N-point stage down, so skip the stages above n
+        const float* twRe = twiddleRe.data() + (size - n);
+        const float* twIm = twiddleIm.data() + (size - n);
+
+        for (int len = n; len >= 8; len >>= 1)
+        {
+            const int h = len / 2;
+            for (int start = 0; start < n; start += len)
+                butterflies (re + start, im + start, h, twRe, twIm);
+            twRe += h;
+            twIm += h;
+        }
+
+        // Last two stages (twiddles 1, −i and 1) fused per 4-point block
+        for (int start = 0; start < n; start += 4)
+        {
+            float* r = re + start;
+            float* i = im + start;
+            const float s0r = r[0] + r[2], s0i = i[0] + i[2];
+            const float s1r = r[1] + r[3], s1i = i[1] + i[3];
+            const float d0r = r[0] - r[2], d0i = i[0] - i[2];
+            const float d1r = i[1] - i[3], d1i = r[3] - r[1]; // (r1 − r3)·(−i)
+            r[0] = s0r + s1r; i[0] = s0i + s1i;
+            r[1] = s0r - s1r; i[1] = s0i - s1i;
+            r[2] = d0r + d1r; i[2] = d0i + d1i;
+            r[3] = d0r - d1r; i[3] = d0i - d1i;
+        }
+    }
+
+    /** One DIF stage on a block: (a, b) → (a + b, (a − b)·w), h a multiple of 4. */
+    static void butterflies (float* re, float* im, int h, const float* wRe, const float* wIm) noexcept
+    {
+        float* re2 = re + h;
+        float* im2 = im + h;
+
+       #if JUCE_INTEL
+        for (int j = 0; j < h; j += 4)
+        {
+            const __m128 ar = _mm_loadu_ps (re + j),  ai = _mm_loadu_ps (im + j);
+            const __m128 br = _mm_loadu_ps (re2 + j), bi = _mm_loadu_ps (im2 + j);
+            const __m128 dr = _mm_sub_ps (ar, br),    di = _mm_sub_ps (ai, bi);
+            const __m128 wr = _mm_loadu_ps (wRe + j), wi = _mm_loadu_ps (wIm + j);
+            _mm_storeu_ps (re + j,  _mm_add_ps (ar, br));
+            _mm_storeu_ps (im + j,  _mm_add_ps (ai, bi));
+            _mm_storeu_ps (re2 + j, _mm_sub_ps (_mm_mul_ps (dr, wr), _mm_mul_ps (di, wi)));
+            _mm_storeu_ps (im2 + j, _mm_add_ps (_mm_mul_ps (dr, wi), _mm_mul_ps (di, wr)));
+        }
+       #else
+        for (int j = 0; j < h; ++j)
+        {
+            const float dr = re[j] - re2[j], di = im[j] - im2[j];
+            re[j] += re2[j];
+            im[j] += im2[j];
+            re2[j] = dr * wRe[j] - di * wIm[j];
+            im2[j] = dr * wIm[j] + di * wRe[j];
+        }
+       #endif
+    }
+
+    //==============================================================================
+    const int half;
+    std::vector<float> twiddleRe, twiddleIm;
+    std::vector<float> untangleRe, untangleIm;
+    std::vector<int>   bitReversed;
+};
+
+//==============================================================================
+inline std::unique_ptr<FftBackend> FftBackend::create (int order, Kind kind)
+{
+    if (kind == Kind::bundled && order >= SplitRealFft::MIN_ORDER)
+        return std::make_unique<SplitRealFft> (order);
+    return std::make_unique<JuceFftBackend> (order);
+}
+
+inline std::unique_ptr<FftBackend> FftBackend::create (int order)
+{
+    return create (order, SNOT_USE_JUCE_FFT ? Kind::juce : Kind::bundled);
+}
@@ -0,0 +1,298 @@
+#pragma once
+#include <JuceHeader.h>
+#if JUCE_INTEL
+ #include <emmintrin.h>
+#endif
+
+//==============================================================================
+/**
+ * TaskGraphView — the dependency structure of one parallel job.
+ * All arrays are owned by the caller (a compiled GraphSnapshot) and are
+ * read-only during run(), except pendingDeps which is per-block scratch.
+ */
+struct TaskGraphView
+{
+    int               numTasks       { 0 };
+    const int*        numDeps        { nullptr }; // upstream task count per task
+    const int*        firstDependent { nullptr }; // index into dependents
+    const int*        numDependents  { nullptr };
+    const int*        dependents     { nullptr };
+    std::atomic<int>* pendingDeps    { nullptr }; // numTasks counters
+};
+
+//==============================================================================
+/**
+ * WorkStealingDeque — fixed-capacity Chase–Lev deque of task indices.
+ *
+ * The owning worker pushes and pops at the bottom; every other worker
+ * steals from the top. Each task is pushed exactly once per job and the
+ * deque is reset between jobs, so indices never wrap and no storage is
+ * ever reallocated.
+ */
+class WorkStealingDeque
+{
+public:
+    static constexpr int CAPACITY = 1024;
+
+    void reset() noexcept
+    {
+        top.store (0, std::memory_order_relaxed);
+        bottom.store (0, std::memory_order_relaxed);
+    }
+
+    /** Owner only. */
+    void push (int task) noexcept
+    {
+        const auto b = bottom.load (std::memory_order_relaxed);
+        items[static_cast<size_t> (b & MASK)].store (task, std::memory_order_relaxed);
+        bottom.store (b + 1, std::memory_order_release);
+    }
+
+    /** Owner only. */
+    bool pop (int& task) noexcept
+    {
+        const auto b = bottom.load (std::memory_order_relaxed) - 1;
+        bottom.store (b, std::memory_order_relaxed);
+        std::atomic_thread_fence (std::memory_order_seq_cst);
+        auto t = top.load (std::memory_order_relaxed);
+
+        if (t > b)
+        {
+            bottom.store (b + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        task = items[static_cast<size_t> (b & MASK)].load (std::memory_order_relaxed);
+        if (t != b) return true;
+
+        // Last item — race any thief for it
+        const bool won = top.compare_exchange_strong (t, t + 1, std::memory_order_seq_cst,
+                                                      std::memory_order_relaxed);
+        bottom.store (b + 1, std::memory_order_relaxed);
+        return won;
+    }
+
+    /** Any thread. */
+    bool steal (int& task) noexcept
+    {
+        auto t = top.load (std::memory_order_acquire);
+        std::atomic_thread_fence (std::memory_order_seq_cst);
+        const auto b = bottom.load (std::memory_order_acquire);
+        if (t >= b) return false;
+
+        task = items[static_cast<size_t> (t & MASK)].load (std::memory_order_relaxed);
+        return top.compare_exchange_strong (t, t + 1, std::memory_order_seq_cst,
+                                            std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr juce::int64 MASK = CAPACITY - 1;
+
+    alignas (64) std::atomic<juce::int64> top    { 0 };
+    alignas (64) std::atomic<juce::int64> bottom { 0 };
+    std::array<std::atomic<int>, CAPACITY> items {};
+};
+
+//==============================================================================
+/**
+ * GraphWorkerPool
+ *
+ * Realtime-safe helper threads for running independent graph branches in
+ * parallel. The audio thread calls run() and takes part as worker 0;
+ * helpers wake on an epoch counter, join the job, and pull ready tasks from
+ * their own deque or steal from the others. A task becomes ready when its
+ * dependency counter hits zero. run() takes no locks and allocates nothing —
+ * threads and deques are created up front on the message thread.
+ */
+class GraphWorkerPool
+{
+public:
+    using TaskFn = void (*) (void* context, int task);
+
+    static constexpr int MAX_WORKERS = 7; // helpers, not counting the audio thread
+    static constexpr int MAX_TASKS   = WorkStealingDeque::CAPACITY;
+
+    GraphWorkerPool() = default;
+
+    ~GraphWorkerPool()
+    {
+        for (auto& w : workers)
+            w->signalThreadShouldExit();
+
+        epoch.fetch_add (1, std::memory_order_release);
+        epoch.notify_all();
+
+        for (auto& w : workers)
+            w->stopThread (1000);
+    }
+
+    //==============================================================================
+    /** Message thread: start helpers until at least n exist. Never shrinks. */
+    void ensureWorkers (int n)
+    {
+        n = juce::jlimit (0, MAX_WORKERS, n);
+        while (static_cast<int> (workers.size()) < n)
+        {
+            const int index = static_cast<int> (workers.size()) + 1;
+            workers.push_back (std::make_unique<Worker> (*this, index));
+            workers.back()->startRealtimeThread (juce::Thread::RealtimeOptions{});
+            numWorkers.store (static_cast<int> (workers.size()), std::memory_order_release);
+        }
+    }
+
+    int getNumWorkers() const noexcept { return numWorkers.load (std::memory_order_acquire); }
+
+    //==============================================================================
+    /** Audio thread: execute every task of the graph, returning when all are done. */
+    void run (const TaskGraphView& graph, TaskFn fn, void* context) noexcept
+    {
+        jassert (graph.numTasks <= MAX_TASKS);
+
+        job = { graph, fn, context };
+        for (auto& d : deques)
+            d.reset();
+
+        for (int i = 0; i < graph.numTasks; ++i)
+            graph.pendingDeps[i].store (graph.numDeps[i], std::memory_order_relaxed);
+        remaining.store (graph.numTasks, std::memory_order_relaxed);
+
+        for (int i = 0; i < graph.numTasks; ++i)
+            if (graph.numDeps[i] == 0)
+                deques[0].push (i);
+
+        // Open the job and wake helpers
+        joinState.store (JOB_OPEN, std::memory_order_release);
+        epoch.fetch_add (1, std::memory_order_release);
+        epoch.notify_all();
+
+        workLoop (0);
+
+        // Close the job; wait for helpers still finishing their last task
+        joinState.fetch_and (~JOB_OPEN, std::memory_order_acq_rel);
+        while ((joinState.load (std::memory_order_acquire) & ~JOB_OPEN) != 0)
+            cpuRelax();
+    }
+
+private:
+    //==============================================================================
+    class Worker : public juce::Thread
+    {
+    public:
+        Worker (GraphWorkerPool& p, int i)
+            : juce::Thread ("SNOT graph worker " + juce::String (i)), pool (p), index (i) {}
+
+        void run() override
+        {
+            auto seen = pool.epoch.load (std::memory_order_acquire);
+
+            while (! threadShouldExit())
+            {
+                // Brief spin for back-to-back blocks, then sleep on the epoch
+                auto e = pool.epoch.load (std::memory_order_acquire);
+                for (int spin = 0; spin < 2000 && e == seen; ++spin)
+                {
+                    cpuRelax();
+                    e = pool.epoch.load (std::memory_order_acquire);
+                }
+
+                if (e == seen)
+                {
+                    pool.epoch.wait (seen, std::memory_order_acquire);
+                    continue;
+                }
+
+                seen = e;
+                if (pool.tryJoin())
+                {
+                    juce::ScopedNoDenormals noDenormals;
+                    pool.workLoop (index);
+                    pool.leave();
+                }
+            }
+        }
+
+    private:
+        GraphWorkerPool& pool;
+        const int index;
+    };
+
+    struct Job
+    {
+        TaskGraphView graph;
+        TaskFn        fn      { nullptr };
+        void*         context { nullptr };
+    };
+
+    //==============================================================================
+    static constexpr juce::uint32 JOB_OPEN = 0x80000000u;
+
+    bool tryJoin() noexcept
+    {
+        auto s = joinState.load (std::memory_order_relaxed);
+        while ((s & JOB_OPEN) != 0)
+            if (joinState.compare_exchange_weak (s, s + 1, std::memory_order_acquire,
+                                                 std::memory_order_relaxed))
+                return true;
+        return false;
+    }
+
+    void leave() noexcept { joinState.fetch_sub (1, std::memory_order_release); }
+
+    void workLoop (int self) noexcept
+    {
+        while (remaining.load (std::memory_order_acquire) > 0)
+        {
+            int task = -1;
+            if (deques[static_cast<size_t> (self)].pop (task) || stealAny (self, task))
+            {
+                job.fn (job.context, task);
+                complete (self, task);
+            }
+            else
+            {
+                cpuRelax();
+            }
+        }
+    }
+
+    bool stealAny (int self, int& task) noexcept
+    {
+        const int participants = getNumWorkers() + 1;
+        for (int k = 1; k < participants; ++k)
+            if (deques[static_cast<size_t> ((self + k) % participants)].steal (task))
+                return true;
+        return false;
+    }
+
+    void complete (int self, int task) noexcept
+    {
+        const auto& g = job.graph;
+        const int* dep = g.dependents + g.firstDependent[task];
+        for (int i = 0; i < g.numDependents[task]; ++i)
+            if (g.pendingDeps[dep[i]].fetch_sub (1, std::memory_order_acq_rel) == 1)
+                deques[static_cast<size_t> (self)].push (dep[i]);
+
+        remaining.fetch_sub (1, std::memory_order_acq_rel);
+    }
+
+    static inline void cpuRelax() noexcept
+    {
+       #if JUCE_INTEL
+        _mm_pause();
+       #else
+        std::this_thread::yield();
+       #endif
+    }
+
+    //==============================================================================
+    Job job;
+    std::array<WorkStealingDeque, MAX_WORKERS + 1> deques;
+    std::vector<std::unique_ptr<Worker>>           workers;
+
+    alignas (64) std::atomic<int>          remaining  { 0 };
+    alignas (64) std::atomic<juce::uint32> joinState  { 0 };
+    alignas (64) std::atomic<juce::uint32> epoch      { 0 };
+    std::atomic<int>                       numWorkers { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GraphWorkerPool)
+};
@@ -1,7 +1,7 @@
 #pragma once
 #include <JuceHeader.h>
-
-class ModulationMatrix;
+#include "ModulationBuses.h"
+#include "SnapshotExchange.h"
 
 //==============================================================================
 /**
@@ -17,14 +17,55 @@ struct MacroMapping
     bool         bipolar   { false };
 };
 
+//==============================================================================
+/**
+ * CompiledMacroMap — every mapping flattened for the audio thread.
+ *
+ * Entries are grouped by macro. Each mapping's offset is sampled at
+ * LUT_SIZE evenly spaced macro positions, with the curve, range and
+ * polarity already applied, and stored row by row: row r holds every
+ * entry of the group at position r, so evaluating a group is two vector
+ * operations over contiguous floats, whatever its size.
+ *
+ * Immutable once published, apart from the audio thread's scratch.
+ */
+struct CompiledMacroMap
+{
+    static constexpr int LUT_SIZE = 65;
+
+    struct Group
+    {
+        int first       { 0 }; // first entry
+        int count       { 0 };
+        int tableOffset { 0 }; // LUT_SIZE rows of count floats
+    };
+
+    std::array<Group, 8> groups;
+    std::vector<int>     lanes; // ModulationBuses lane per entry
+    std::vector<float>   table; // offset at each sample position
+    std::vector<float>   slope; // next row minus this one (last row repeats)
+
+    mutable std::vector<float> offsets; // audio thread: per entry, at its macro's last value
+
+    int getNumEntries() const noexcept { return static_cast<int> (lanes.size()); }
+};
+
 //==============================================================================
 /**
  * MacroEngine
  *
  * Manages 8 macro knobs that can each drive N parameter targets.
- * Macro values are written to APVTS (automation-compatible).
- * The mapping from macro value → parameter delta is applied here
- * before being forwarded to the ModulationMatrix.
+ * The macros themselves are APVTS parameters (automation-compatible);
+ * their targets are not written. Each mapping adds a normalised offset to
+ * its target's ModulationBuses lane: span × curve (macro), where span is
+ * the mapping's range in the target's normalised units (centred on zero
+ * when bipolar). The target's knob stays where the user left it.
+ *
+ * Mappings are compiled into a CompiledMacroMap whenever they change, so
+ * a block costs one table interpolation per macro and one add per target.
+ * Maps are published to the audio thread through a SnapshotExchange:
+ * editing mappings during playback never locks or races the audio thread,
+ * and a block always sees one complete map.
  *
  * Macro metadata (display name, colour, assignments) is stored
  * in a ValueTree for preset serialization.
@@ -54,38 +95,53 @@ public:
                 juce::Colour(0xffff2222), juce::Colour(0xffccff00)
             };
             slots[i].colour = palette[i];
-            pMacros[i] = apvts.getRawParameterValue ("macro_" + juce::String (i + 1));
+            pMacros[i] = apvts.getRawParameterValue (ParamIndex::table[ParamIndex::MACRO_1 + i].id);
         }
+        compile();
     }
 
-    void setModulationMatrix (ModulationMatrix* m) { modMatrix = m; }
-
     //==============================================================================
-    /** Called on audio thread — reads macro values and dispatches to targets. */
-    void process (int numSamples)
+    /**
+     * Called on audio thread, after ModulationMatrix::process() has opened
+     * the block — adds every mapping's offset to its target's lane, reading
+     * the macros from the block's parameter snapshot.
+     */
+    void process (const ParameterValues& values, ModulationBuses& buses) noexcept
     {
-        juce::ignoreUnused (numSamples);
+        constexpr int LUT_SIZE = CompiledMacroMap::LUT_SIZE;
+        using FVO = juce::FloatVectorOperations;
+
+        const auto* map = compiledMaps.acquire();
+        if (map == nullptr) return;
+
+        // A new map's scratch starts empty
+        if (map != adoptedMap)
+        {
+            adoptedMap = map;
+            std::fill (std::begin (lastMacroValue), std::end (lastMacroValue), -1.0f);
+        }
+
         for (int m = 0; m < NUM_MACROS; ++m)
         {
-            const float value = pMacros[m]->load (std::memory_order_relaxed);
-            if (std::abs (value - lastMacroValue[m]) < 1e-6f) continue;
-            lastMacroValue[m] = value;
+            const auto& group = map->groups[static_cast<size_t> (m)];
+            if (group.count == 0) continue;
 
-            for (auto& mapping : slots[m].mappings)
+            // Re-interpolate the group only when its macro has moved
+            const float value = juce::jlimit (0.0f, 1.0f, values.get (ParamIndex::MACRO_1 + m));
+            if (value != lastMacroValue[m])
             {
-                const float curved = (mapping.curve == 1.0f)
-                    ? value
-                    : std::pow (value, mapping.curve);
-
-                const float target = juce::jmap (curved, 0.0f, 1.0f,
-                                                  mapping.rangeMin, mapping.rangeMax);
-
-                if (auto* param = apvts.getParameter (mapping.paramID))
-                {
-                    const auto& range = apvts.getParameterRange (mapping.paramID);
-                    param->setValueNotifyingHost (range.convertTo0to1 (target));
-                }
+                lastMacroValue[m] = value;
+                const float x    = value * static_cast<float> (LUT_SIZE - 1);
+                const int   row  = juce::jmin (static_cast<int> (x), LUT_SIZE - 1);
+                const auto  base = static_cast<size_t> (group.tableOffset + row * group.count);
+
+                float* out = map->offsets.data() + group.first;
+                FVO::copy (out, map->table.data() + base, group.count);
+                FVO::addWithMultiply (out, map->slope.data() + base, x - static_cast<float> (row), group.count);
             }
+
+            for (int j = group.first; j < group.first + group.count; ++j)
+                buses.add (map->lanes[static_cast<size_t> (j)], map->offsets[static_cast<size_t> (j)]);
         }
     }
 
@@ -94,12 +150,14 @@ public:
     {
         jassert (macroIndex >= 0 && macroIndex < NUM_MACROS);
         slots[macroIndex].mappings.push_back (mapping);
+        compile();
     }
 
     void clearMappings (int macroIndex)
     {
         jassert (macroIndex >= 0 && macroIndex < NUM_MACROS);
         slots[macroIndex].mappings.clear();
+        compile();
     }
 
     void setMacroName   (int i, const juce::String& n) { slots[i].name = n; }
@@ -152,14 +210,74 @@ public:
                 slots[m].mappings.push_back (mapping);
             }
         }
+        compile();
     }
 
 private:
+    /** Message thread: compile the slots into a new map and publish it. */
+    void compile()
+    {
+        constexpr int LUT_SIZE = CompiledMacroMap::LUT_SIZE;
+        auto compiled = std::make_unique<CompiledMacroMap>();
+        auto& map = *compiled;
+
+        for (int m = 0; m < NUM_MACROS; ++m)
+        {
+            // Only mappings whose target exists make it into the table
+            std::vector<std::pair<int, const MacroMapping*>> resolved;
+            for (auto& mapping : slots[m].mappings)
+                if (auto* param = apvts.getParameter (mapping.paramID))
+                    resolved.emplace_back (param->getParameterIndex(), &mapping);
+
+            auto& group = map.groups[static_cast<size_t> (m)];
+            group.first       = map.getNumEntries();
+            group.count       = static_cast<int> (resolved.size());
+            group.tableOffset = static_cast<int> (map.table.size());
+            map.table.resize (map.table.size() + static_cast<size_t> (LUT_SIZE * group.count));
+
+            for (int j = 0; j < group.count; ++j)
+            {
+                const auto& [lane, mapping] = resolved[static_cast<size_t> (j)];
+                map.lanes.push_back (lane);
+
+                auto* param = apvts.getParameter (mapping->paramID);
+                const float span = param->convertTo0to1 (mapping->rangeMax)
+                                 - param->convertTo0to1 (mapping->rangeMin);
+
+                for (int r = 0; r < LUT_SIZE; ++r)
+                {
+                    const float x      = static_cast<float> (r) / static_cast<float> (LUT_SIZE - 1);
+                    const float curved = (mapping->curve == 1.0f) ? x : std::pow (x, mapping->curve);
+                    map.table[static_cast<size_t> (group.tableOffset + r * group.count + j)]
+                        = span * (mapping->bipolar ? curved - 0.5f : curved);
+                }
+            }
+        }
+
+        map.slope.resize (map.table.size());
+        for (const auto& group : map.groups)
+            for (int r = 0; r < LUT_SIZE; ++r)
+                for (int j = 0; j < group.count; ++j)
+                {
+                    const auto i = static_cast<size_t> (group.tableOffset + r * group.count + j);
+                    map.slope[i] = r + 1 < LUT_SIZE ? map.table[i + static_cast<size_t> (group.count)] - map.table[i] : 0.0f;
+                }
+
+        map.offsets.assign (map.lanes.size(), 0.0f);
+        compiledMaps.publish (std::move (compiled));
+    }
+
     juce::AudioProcessorValueTreeState& apvts;
-    ModulationMatrix*                   modMatrix { nullptr };
 
-    MacroSlot  slots[NUM_MACROS];
-    float      lastMacroValue[NUM_MACROS] {};
+    MacroSlot  slots[NUM_MACROS]; // message thread model
+
+    static_assert (std::tuple_size<decltype (CompiledMacroMap::groups)>::value == NUM_MACROS);
+
+    SnapshotExchange<CompiledMacroMap> compiledMaps;
+
+    // Audio thread
+    const CompiledMacroMap* adoptedMap { nullptr };
+    float                   lastMacroValue[NUM_MACROS] {};
 
     std::atomic<float>* pMacros[NUM_MACROS] {};
 
@@ -177,7 +295,7 @@ struct ModSource
     Type  type    { LFO_SINE };
     float rate    { 1.0f };   // Hz for LFOs
     float depth   { 0.5f };
-    float phase   { 0.0f };   // current phase 0..1
+    float phase   { 0.0f };   // start phase 0..1
     bool  bpmSync { false };
     float syncDiv { 4.0f };   // beat division
 
@@ -198,6 +316,7 @@ struct ModRoute
     juce::String paramID;
     float        amount    { 0.5f }; // ±1
     bool         bipolar   { true };
+    int          paramIndex { -1 };  // lane, resolved by addRoute
 };
 
 //==============================================================================
@@ -205,75 +324,128 @@ struct ModRoute
  * ModulationMatrix
  *
  * Manages all modulation sources (LFOs, envelopes) and their routing
- * to parameters. Values are accumulated per-block and written to
- * parameter modulation offsets.
+ * to parameters. Sources tick once per block and the routed values are
+ * summed into ModulationBuses lanes, which nodes interpolate across the
+ * block and add to the parameters' base values. Parameters themselves are
+ * never written, so modulation neither accumulates nor shows up in the
+ * host's automation.
  *
- * Thread-safety: sources/routes modified on message thread (lock-protected),
- * process() called on audio thread (reads a stable snapshot).
+ * Thread-safety: sources and routes are edited on the message thread, which
+ * publishes them as an immutable Config through a SnapshotExchange; process()
+ * adopts the newest Config at the start of a block and never locks. Source
+ * phases live on the audio side, indexed by source, so LFOs keep running
+ * smoothly across edits.
  */
 class ModulationMatrix
 {
 public:
+    static constexpr int MAX_SOURCES = 16;
+
+    /** Everything process() needs to know about the routing; immutable once published. */
+    struct Config
+    {
+        std::vector<ModSource> sources;
+        std::vector<ModRoute>  routes; // paramIndex resolved, sourceIndex in range
+        int sourceEpoch { 0 };         // bumped by clearAll(): every index now names a new source
+    };
+
     explicit ModulationMatrix (juce::AudioProcessorValueTreeState& apvts)
-        : apvts (apvts) {}
+        : apvts (apvts),
+          buses (static_cast<int> (apvts.processor.getParameters().size()))
+    {
+        publish();
+    }
 
     void prepare (double sr, int /*blockSize*/)
     {
         sampleRate = sr;
+        buses.reset();
+        phases.fill (0.0f);
+        numPhases = 0;
     }
 
+    /** The offsets process() writes; handed to ModuleGraph for its nodes. */
+    const ModulationBuses& getBuses() const noexcept { return buses; }
+
+    /** Audio thread, after process(): where MacroEngine adds its offsets. */
+    ModulationBuses& getBuses() noexcept { return buses; }
+
     //==============================================================================
-    /** Tick all sources, write accumulated modulation to parameters. */
-    void process (int numSamples)
+    /** Tick all sources to the end of the block and sum each route into its lane. */
+    void process (int numSamples) noexcept
     {
         const float dt = static_cast<float> (numSamples) / static_cast<float> (sampleRate);
+        buses.beginBlock();
+
+        const auto* config = configs.acquire();
+        if (config == nullptr) return;
+
+        // Sources added since the last block start at their own phase; after
+        // a clear, every source is new even if the count has grown back
+        if (config->sourceEpoch != phaseEpoch)
+        {
+            phaseEpoch = config->sourceEpoch;
+            numPhases  = 0;
+        }
+
+        const int numSources = static_cast<int> (config->sources.size());
+        for (int i = numPhases; i < numSources; ++i)
+            phases[static_cast<size_t> (i)] = config->sources[static_cast<size_t> (i)].phase;
+        numPhases = numSources;
 
         // Update source phases
-        for (auto& src : sources)
+        for (size_t i = 0; i < config->sources.size(); ++i)
         {
+            const auto& src = config->sources[i];
             if (src.type == ModSource::ENVELOPE) continue;
-            src.phase += src.rate * dt;
-            if (src.phase > 1.0f) src.phase -= 1.0f;
+            auto& phase = phases[i];
+            phase += src.rate * dt;
+            if (phase > 1.0f) phase -= 1.0f;
         }
 
         // Compute source values and apply to routes
-        for (auto& route : routes)
+        for (const auto& route : config->routes)
         {
-            if (route.sourceIndex >= (int)sources.size()) continue;
-            auto& src = sources[route.sourceIndex];
+            const auto i = static_cast<size_t> (route.sourceIndex);
+            const auto& src = config->sources[i];
 
-            float value = computeSourceValue (src);
+            float value = computeSourceValue (src, phases[i]);
+            if (! route.bipolar)
+                value = 0.5f * (value + src.depth); // 0 … depth
             value *= route.amount;
 
-            // Modulate parameter (additive, clamped)
-            if (auto* param = apvts.getParameter (route.paramID))
-            {
-                const float current = param->getValue();
-                param->setValueNotifyingHost (
-                    juce::jlimit (0.0f, 1.0f, current + value * 0.01f));
-            }
+            // Normalised offset; nodes clamp base + offset to the range
+            buses.add (route.paramIndex, value);
         }
     }
 
     //==============================================================================
+    /** Message thread. Returns the source's index, or -1 if MAX_SOURCES are in use. */
     int addSource (const ModSource& src)
     {
-        const juce::ScopedLock sl (lock);
+        if (sources.size() >= static_cast<size_t> (MAX_SOURCES))
+            return -1;
+
         sources.push_back (src);
+        publish();
         return static_cast<int> (sources.size() - 1);
     }
 
+    /** Message thread. Routes to unknown parameters or sources are kept but inert. */
     void addRoute (const ModRoute& route)
     {
-        const juce::ScopedLock sl (lock);
         routes.push_back (route);
+        if (auto* param = apvts.getParameter (route.paramID))
+            routes.back().paramIndex = param->getParameterIndex();
+        publish();
     }
 
     void clearAll()
     {
-        const juce::ScopedLock sl (lock);
         sources.clear();
         routes.clear();
+        ++sourceEpoch;
+        publish();
     }
 
     //==============================================================================
@@ -281,17 +453,30 @@ public:
     void fromValueTree (const juce::ValueTree&) {}
 
 private:
-    float computeSourceValue (const ModSource& src) const
+    /** Message thread: hand the current sources and live routes to the audio thread. */
+    void publish()
+    {
+        auto config = std::make_unique<Config>();
+        config->sources     = sources;
+        config->sourceEpoch = sourceEpoch;
+        for (const auto& route : routes)
+            if (route.paramIndex >= 0 && juce::isPositiveAndBelow (route.sourceIndex, static_cast<int> (sources.size())))
+                config->routes.push_back (route);
+
+        configs.publish (std::move (config));
+    }
+
+    static float computeSourceValue (const ModSource& src, float phase) noexcept
     {
         switch (src.type)
         {
             case ModSource::LFO_SINE:
-                return std::sin (src.phase * juce::MathConstants<float>::twoPi) * src.depth;
+                return std::sin (phase * juce::MathConstants<float>::twoPi) * src.depth;
             case ModSource::LFO_TRI:
-                return (src.phase < 0.5f ? src.phase * 4.0f - 1.0f
-                                         : 3.0f - src.phase * 4.0f) * src.depth;
+                return (phase < 0.5f ? phase * 4.0f - 1.0f
+                                     : 3.0f - phase * 4.0f) * src.depth;
             case ModSource::LFO_SQUARE:
-                return (src.phase < 0.5f ? 1.0f : -1.0f) * src.depth;
+                return (phase < 0.5f ? 1.0f : -1.0f) * src.depth;
             case ModSource::LFO_RANDOM:
                 return 0.0f; // Would use S&H in practice
             default:
@@ -300,9 +485,18 @@ private:
     }
 
     juce::AudioProcessorValueTreeState& apvts;
+    ModulationBuses        buses;
+
+    // Message thread model
     std::vector<ModSource> sources;
     std::vector<ModRoute>  routes;
-    juce::CriticalSection  lock;
+    int                    sourceEpoch { 0 };
+    SnapshotExchange<Config> configs;
+
+    // Audio thread
+    std::array<float, MAX_SOURCES> phases {};
+    int                            numPhases  { 0 };
+    int                            phaseEpoch { 0 };
     double sampleRate { 44100.0 };
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ModulationMatrix)
@@ -0,0 +1,154 @@
+#pragma once
+#include <JuceHeader.h>
+#include "ParameterSnapshot.h"
+
+//==============================================================================
+/**
+ * ModulationBuses
+ *
+ * Control-rate modulation offsets, one lane per host parameter (by
+ * parameter index), in normalised units. The ModulationMatrix writes a
+ * lane's value for the end of each block; the value at the start is the
+ * previous block's end, so readers interpolate across the block and
+ * modulation never steps. Nothing here touches the parameters themselves:
+ * the host-visible value stays what the user or automation set.
+ *
+ * Written by the audio callback before the graph renders, read by nodes
+ * while it renders (possibly on GraphWorkerPool threads, which the pool
+ * orders after the write).
+ */
+class ModulationBuses
+{
+public:
+    /** One lane over the current block. */
+    struct Offset
+    {
+        float start { 0.0f };
+        float end   { 0.0f };
+
+        bool isZero() const noexcept { return start == 0.0f && end == 0.0f; }
+    };
+
+    explicit ModulationBuses (int numParameters = 0) { setNumLanes (numParameters); }
+
+    /** Message thread, before processing starts. */
+    void setNumLanes (int numParameters)
+    {
+        startOffsets.assign (static_cast<size_t> (juce::jmax (0, numParameters)), 0.0f);
+        endOffsets  .assign (static_cast<size_t> (juce::jmax (0, numParameters)), 0.0f);
+    }
+
+    int getNumLanes() const noexcept { return static_cast<int> (endOffsets.size()); }
+
+    //==============================================================================
+    /** Audio thread: last block's end becomes this block's start; lanes restart at 0. */
+    void beginBlock() noexcept
+    {
+        std::swap (startOffsets, endOffsets);
+        std::fill (endOffsets.begin(), endOffsets.end(), 0.0f);
+    }
+
+    /** Audio thread: accumulate into a lane's end-of-block value. */
+    void add (int lane, float amount) noexcept
+    {
+        if (lane >= 0 && lane < getNumLanes())
+            endOffsets[static_cast<size_t> (lane)] += amount;
+    }
+
+    Offset get (int lane) const noexcept
+    {
+        if (lane < 0 || lane >= getNumLanes())
+            return {};
+        return { startOffsets[static_cast<size_t> (lane)], endOffsets[static_cast<size_t> (lane)] };
+    }
+
+    void reset() noexcept
+    {
+        std::fill (startOffsets.begin(), startOffsets.end(), 0.0f);
+        std::fill (endOffsets.begin(),   endOffsets.end(),   0.0f);
+    }
+
+private:
+    std::vector<float> startOffsets, endOffsets;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ModulationBuses)
+};
+
+//==============================================================================
+/**
+ * ModulatedParameter — a node's view of one parameter: its value in the
+ * block's ParameterValues plus its modulation lane, in the parameter's own
+ * units. Without a snapshot (a node outside a graph) it reads the APVTS.
+ *
+ *     const auto drive = pDrive.getRamp (context.parameters, context.modulation, context.numSamples);
+ *     for (int s = 0; s < numSamples; ++s)
+ *         process (x, drive.at (s));
+ */
+class ModulatedParameter
+{
+public:
+    /** Linear per-sample interpolation across one block. */
+    struct Ramp
+    {
+        float start { 0.0f };
+        float step  { 0.0f };
+
+        float at (int sample) const noexcept { return start + step * static_cast<float> (sample); }
+        float getEnd (int numSamples) const noexcept { return at (numSamples); }
+        bool  isConstant() const noexcept { return step == 0.0f; }
+    };
+
+    ModulatedParameter (juce::AudioProcessorValueTreeState& apvts, ParamIndex::Index index)
+        : param (dynamic_cast<juce::RangedAudioParameter*> (apvts.processor.getParameters()[index])),
+          base  (apvts.getRawParameterValue (ParamIndex::table[index].id)),
+          lane  (index)
+    {
+        jassert (param != nullptr && base != nullptr && param->getParameterIndex() == index);
+    }
+
+    /** The unmodulated value straight from the APVTS, for message-thread queries. */
+    float getBaseValue() const noexcept { return base->load(); }
+
+    /** The unmodulated value in the block's snapshot, as set by the user or automation. */
+    float getBaseValue (const ParameterValues* values) const noexcept
+    {
+        return values != nullptr ? values->get (lane) : base->load();
+    }
+
+    /** Base plus modulation at the start and end of the block, clamped to the range. */
+    ModulationBuses::Offset getBlockValues (const ParameterValues* values, const ModulationBuses* buses) const noexcept
+    {
+        const float value = getBaseValue (values);
+        const auto  offset = buses != nullptr ? buses->get (lane) : ModulationBuses::Offset {};
+        if (offset.isZero())
+            return { value, value };
+
+        const float norm = param->convertTo0to1 (value);
+        return { param->convertFrom0to1 (juce::jlimit (0.0f, 1.0f, norm + offset.start)),
+                 param->convertFrom0to1 (juce::jlimit (0.0f, 1.0f, norm + offset.end)) };
+    }
+
+    Ramp getRamp (const ParameterValues* values, const ModulationBuses* buses, int numSamples) const noexcept
+    {
+        const auto v = getBlockValues (values, buses);
+        return { v.start, numSamples > 0 ? (v.end - v.start) / static_cast<float> (numSamples) : 0.0f };
+    }
+
+    /** Block-end value, for code that only updates once per block. */
+    float getValue (const ParameterValues* values, const ModulationBuses* buses) const noexcept
+    {
+        return getBlockValues (values, buses).end;
+    }
+
+    /** The larger of the block's start and end values, for worst-case estimates such as tails. */
+    float getMaxValue (const ParameterValues* values, const ModulationBuses* buses) const noexcept
+    {
+        const auto v = getBlockValues (values, buses);
+        return juce::jmax (v.start, v.end);
+    }
+
+private:
+    juce::RangedAudioParameter* param { nullptr };
+    std::atomic<float>*         base  { nullptr };
+    int                         lane  { -1 }; // dense ParamIndex, also the bus lane
+};
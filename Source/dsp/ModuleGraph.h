@@ -1,16 +1,10 @@
 #pragma once
 #include <JuceHeader.h>
+#include <unordered_set>
 #include "AudioNode.h"
-#include "modules/SpectralWarpChorus.h"
-#include "modules/PortalReverb.h"
-#include "modules/PitchSmearDelay.h"
-#include "modules/Harmonic808Inflator.h"
-#include "modules/GravityCurveFilter.h"
-#include "modules/PlasmaDistortion.h"
-#include "modules/StereoNeuralMotion.h"
-#include "modules/TextureGenerator.h"
-#include "modules/FreezeCapture.h"
-#include "modules/MutationEngine.h"
+#include "GraphWorkerPool.h"
+#include "NodeFactory.h"
+#include "StaticChain.h"
 
 //==============================================================================
 /** Represents a directed connection between two nodes in the graph. */
@@ -23,6 +17,95 @@ struct NodeConnection
     float weight      { 1.0f }; // mix weight for parallel lanes
 };
 
+//==============================================================================
+/** One upstream feed of a render step, resolved to a buffer slot. */
+struct RenderInput
+{
+    int   slot       { -1 };
+    float weight     { 1.0f };
+    int   sourceStep { -1 }; // producing step, -1 = main input
+};
+
+/**
+ * One unit of work in the compiled render plan: a single node, or a serial
+ * run of nonlinear nodes sharing one oversampled region.
+ */
+struct RenderStep
+{
+    int  firstNode    { 0 };     // index into RenderPlan::nodes
+    int  numNodes     { 1 };
+    int  oversampling { 1 };     // region factor, 1 = base rate
+    int  outputSlot   { -1 };
+    int  firstInput   { 0 };     // index into RenderPlan::inputs
+    int  numInputs    { 0 };
+    bool inPlace      { false }; // output shares the slot of input 0
+};
+
+/**
+ * RenderPlan — the graph flattened into topological order.
+ * Rebuilt on the message thread whenever the topology changes so the
+ * audio thread only walks dense arrays (no map lookups, no edge scans).
+ *
+ * Buffers are assigned like registers: slot 0 is the host's main block,
+ * and a slot is reused once every reader of its value has run. A serial
+ * chain therefore processes entirely in place in the main block.
+ */
+struct RenderPlan
+{
+    static constexpr int MAIN_SLOT = 0;
+
+    std::vector<RenderStep>  steps;
+    std::vector<AudioNode*>  nodes;
+    std::vector<RenderInput> inputs;
+    int numSlots   { 1 };
+    int outputSlot { MAIN_SLOT };
+
+    // Dependency structure for parallel scheduling (per step, SoA)
+    std::vector<int> numDeps, firstDependent, numDependents, dependents;
+    int maxParallelism { 1 }; // widest level of the DAG
+};
+
+//==============================================================================
+/**
+ * GraphSnapshot — one immutable, fully prepared version of the graph.
+ *
+ * Built on the message thread after every edit and handed to the audio
+ * thread through an atomic pointer. The audio thread only ever touches
+ * the scratch buffers and renderedLatency; everything else is read-only
+ * once published.
+ * Holding shared node references keeps removed nodes alive until the
+ * snapshot that still renders them has been retired.
+ */
+struct GraphSnapshot
+{
+    std::vector<std::shared_ptr<AudioNode>> nodeRefs;
+    RenderPlan                              plan;
+    std::vector<juce::AudioBuffer<float>>   buffers;     // slots 1..numSlots-1
+    std::vector<float*>                     slotChannels; // numSlots × numChannels
+    std::unique_ptr<std::atomic<int>[]>     pendingDeps; // worker pool scratch
+    std::vector<std::unique_ptr<OversamplingChain>> oversamplers; // per step, null at base rate
+    std::unique_ptr<RenderChain>            staticChain; // set when the plan is a known serial chain
+    int          numChannels { 2 };
+    int          maxSamples  { 0 };
+    double       sampleRate  { 44100.0 };
+    int          latency     { 0 };   // samples along the path to the output
+    bool         isPrepared  { false };
+    juce::uint64 generation  { 0 };
+
+    // Per-block scratch, written by the audio thread before rendering
+    int blockSamples  { 0 };
+    int blockChannels { 0 };
+
+    // Written by the audio thread after rendering: latency as the block carried it
+    std::vector<float> stepLatency;
+    std::atomic<int>   renderedLatency { 0 };
+
+    float* const* getSlot (int slot) const noexcept
+    {
+        return slotChannels.data() + static_cast<size_t> (slot * numChannels);
+    }
+};
+
 //==============================================================================
 /**
  * ModuleGraph
@@ -30,17 +113,36 @@ struct NodeConnection
  * Owns all AudioNodes and manages their routing topology.
  * Supports:
  *   - Serial chain (default linear path)
- *   - Parallel lanes (split → N branches → merge)
+ *   - Parallel lanes (split → N branches → merge), rendered across a
+ *     GraphWorkerPool when the DAG has independent branches
  *   - Any-to-any routing matrix
- *   - Thread-safe graph swap via double-pointer
+ *   - Lock-free graph swap: edits build a new GraphSnapshot on the message
+ *     thread, the audio thread picks it up with an atomic exchange at the
+ *     start of the next block, and retired snapshots are freed by a timer
+ *     back on the message thread.
+ *   - Node sleeping: a node whose input stays below SILENCE_THRESHOLD for
+ *     longer than its tail is skipped until signal returns.
+ *   - Per-node oversampling: nodes that ask for it run inside an up/down
+ *     sampled region (adjacent ones share one), at no more than the global
+ *     Oversampling setting. Everything else stays at the base rate. When a
+ *     node's rate changes, a fresh instance is prepared off the audio thread
+ *     and goes live with the new plan, so the graph keeps playing.
  */
-class ModuleGraph
+class ModuleGraph : private juce::Timer
 {
 public:
+    static constexpr float SILENCE_THRESHOLD = StepRunner::SILENCE_THRESHOLD;
+
     ModuleGraph (juce::AudioProcessorValueTreeState& apvts)
         : apvts (apvts)
     {
         buildDefaultGraph();
+        startTimer (250);
+    }
+
+    ~ModuleGraph() override
+    {
+        stopTimer();
     }
 
     //==============================================================================
@@ -50,17 +152,11 @@ public:
         this->blockSize   = maxBlockSize;
         this->numChannels = numChannels;
 
-        juce::dsp::ProcessSpec spec { sampleRate,
-                                      static_cast<juce::uint32> (maxBlockSize),
-                                      static_cast<juce::uint32> (numChannels) };
-
-        for (auto& [id, node] : nodes)
-            node->prepare (spec);
-
-        // Allocate scratch buffers for each node output
-        nodeBuffers.clear();
-        for (auto& [id, node] : nodes)
-            nodeBuffers[id].setSize (numChannels, maxBlockSize);
+        // The host guarantees the audio thread is stopped while we re-prepare,
+        // so rebuildSnapshot can prepare every node in place
+        preparedFactors.clear();
+        isPrepared = true;
+        rebuildSnapshot();
     }
 
     void reset()
@@ -70,77 +166,172 @@ public:
     }
 
     //==============================================================================
-    /** Main audio processing — walks the graph in topological order. */
+    /** Main audio processing — adopts the newest snapshot, then renders it. */
     void processGraph (juce::dsp::AudioBlock<float>& mainBlock)
     {
-        if (sortedNodeIds.empty()) return;
+        if (auto* next = pendingSnapshot.exchange (nullptr, std::memory_order_acq_rel))
+        {
+            activeSnapshot = next;
+            adoptedGeneration.store (next->generation, std::memory_order_release);
+        }
 
-        // Clear all node output buffers
-        for (auto& [id, buf] : nodeBuffers)
-            buf.clear();
+        if (activeSnapshot != nullptr && activeSnapshot->isPrepared)
+        {
+            renderActiveSnapshot (mainBlock);
+            updateRenderedLatency (*activeSnapshot);
+        }
+    }
 
-        // Feed main input into first node(s)
-        const int samples = static_cast<int> (mainBlock.getNumSamples());
-        auto& inputBuffer = nodeBuffers[sortedNodeIds.front()];
-        for (int ch = 0; ch < numChannels; ++ch)
-            inputBuffer.copyFrom (ch, 0, mainBlock.getChannelPointer(ch), samples);
+    /** Latency of the published graph as its nodes report it, in base-rate samples. Any thread; the host is told this. */
+    int getLatencySamples() const noexcept { return latencySamples.load (std::memory_order_relaxed); }
 
-        // Process each node in sorted order
-        for (int nodeId : sortedNodeIds)
-        {
-            auto& node = nodes[nodeId];
-            if (!node->isEnabled()) continue;
+    /**
+     * Audio thread, after processGraph(): the latency the block just
+     * rendered actually carried, which the processor's dry path follows.
+     * It moves on the block a change is heard, where getLatencySamples()
+     * can lead (a rebuild not yet adopted) or trail (the timer's poll).
+     */
+    int getRenderedLatencySamples() const noexcept
+    {
+        return activeSnapshot != nullptr ? activeSnapshot->renderedLatency.load (std::memory_order_relaxed)
+                                         : getLatencySamples();
+    }
 
-            auto& outBuf = nodeBuffers[nodeId];
+    /** Longest ring-out of the published graph in seconds, summed along its longest path. Any thread. */
+    double getTailLengthSeconds() const noexcept { return tailSeconds.load (std::memory_order_relaxed); }
+
+    /** Message thread: called whenever a rebuild or a node's reported latency changes getLatencySamples(). */
+    std::function<void (int)> onLatencyChanged;
+
+    /** The parameter snapshot, modulation offsets and transport every node reads; set once, before processing starts. */
+    void setBlockSources (const ParameterValues* values, const ModulationBuses* buses,
+                          const TransportInfo* transport)
+    {
+        parameterValues = values;
+        modulationBuses = buses;
+        transportInfo   = transport;
+        for (auto& [id, node] : nodes)
+            node->setBlockSources (values, buses, transport);
+    }
+
+    //==============================================================================
+    /**
+     * Groups edits so the graph is compiled and published once, when the
+     * outermost batch ends, instead of after every call.
+     */
+    class ScopedBatch
+    {
+    public:
+        explicit ScopedBatch (ModuleGraph& g) : graph (g) { ++graph.batchDepth; }
 
-            // Mix inputs from upstream connections
-            for (auto& conn : connections)
+        ~ScopedBatch()
+        {
+            if (--graph.batchDepth == 0 && graph.batchDirty)
             {
-                if (conn.destNodeId != nodeId) continue;
-                auto& srcBuf = nodeBuffers[conn.sourceNodeId];
-                for (int ch = 0; ch < numChannels; ++ch)
-                    outBuf.addFrom (ch, 0, srcBuf, ch, 0, samples, conn.weight);
+                graph.batchDirty = false;
+                graph.rebuildSnapshot();
             }
-
-            // Process the node
-            juce::dsp::AudioBlock<float> block (outBuf);
-            node->process (block);
         }
 
-        // Copy last node's output back to main block
-        auto& outputBuffer = nodeBuffers[sortedNodeIds.back()];
-        for (int ch = 0; ch < numChannels; ++ch)
-            mainBlock.getSingleChannelBlock(ch).copyFrom (
-                juce::dsp::AudioBlock<float> (outputBuffer).getSingleChannelBlock(ch));
-    }
+    private:
+        ModuleGraph& graph;
+        JUCE_DECLARE_NON_COPYABLE (ScopedBatch)
+    };
 
     //==============================================================================
-    /** Add a node and return its assigned ID. */
+    /**
+     * Add a node and return its assigned ID. Prepared by the rebuild, never on
+     * the audio thread. Returns -1, leaving the graph untouched, for a type
+     * NodeFactory can't create: it could be neither restored from a saved
+     * state nor replaced when its rate changes.
+     */
     int addNode (std::unique_ptr<AudioNode> node)
     {
+        if (node == nullptr || ! NodeFactory::getInstance().isRegistered (node->getType()))
+        {
+            jassertfalse;
+            return -1;
+        }
+
         const int id = nextNodeId++;
+        node->setBlockSources (parameterValues, modulationBuses, transportInfo);
         nodes[id] = std::move (node);
-        rebuildTopologicalSort();
+
+        // A node without edges can go anywhere; the end keeps every other position.
+        // It only becomes the output if the graph had none.
+        position[id] = static_cast<int> (sortedNodeIds.size());
+        sortedNodeIds.push_back (id);
+        if (outputNodeId < 0)
+            outputNodeId = id;
+
+        topologyChanged();
         return id;
     }
 
     void removeNode (int nodeId)
     {
-        nodes.erase (nodeId);
-        nodeBuffers.erase (nodeId);
+        auto it = nodes.find (nodeId);
+        if (it == nodes.end()) return;
+
+        preparedFactors.erase (it->second.get());
+        nodes.erase (it);
+
+        // The output's latest-sorted source takes over from it, else the last node
+        if (nodeId == outputNodeId)
+        {
+            const auto& sources = predecessors[nodeId];
+            const auto latest = std::max_element (sources.begin(), sources.end(),
+                                                  [this] (int a, int b) { return position[a] < position[b]; });
+            outputNodeId = latest != sources.end() ? *latest : -1;
+        }
+
+        for (int dst : successors[nodeId])   eraseAll (predecessors[dst], nodeId);
+        for (int src : predecessors[nodeId]) eraseAll (successors[src], nodeId);
+        successors.erase (nodeId);
+        predecessors.erase (nodeId);
+
         connections.erase (
             std::remove_if (connections.begin(), connections.end(),
                 [nodeId](const NodeConnection& c) {
                     return c.sourceNodeId == nodeId || c.destNodeId == nodeId;
                 }),
             connections.end());
-        rebuildTopologicalSort();
+
+        // Removing a node never breaks the order; close the gap it leaves
+        const int pos = position[nodeId];
+        position.erase (nodeId);
+        sortedNodeIds.erase (sortedNodeIds.begin() + pos);
+        for (int i = pos; i < static_cast<int> (sortedNodeIds.size()); ++i)
+            position[sortedNodeIds[static_cast<size_t> (i)]] = i;
+
+        if (outputNodeId < 0 && ! sortedNodeIds.empty())
+            outputNodeId = sortedNodeIds.back();
+
+        topologyChanged();
     }
 
-    void addConnection (NodeConnection conn)
+    /**
+     * Connect two nodes. Returns false, leaving the graph untouched, if either
+     * node doesn't exist or the edge would close a cycle. An edge out of the
+     * output node extends the chain, so its destination becomes the output.
+     */
+    bool addConnection (NodeConnection conn)
     {
+        const int src = conn.sourceNodeId, dst = conn.destNodeId;
+        if (src == dst || nodes.count (src) == 0 || nodes.count (dst) == 0)
+            return false;
+
+        if (! reorderForEdge (src, dst))
+            return false;
+
         connections.push_back (conn);
-        rebuildTopologicalSort();
+        successors[src].push_back (dst);
+        predecessors[dst].push_back (src);
+        if (src == outputNodeId)
+            outputNodeId = dst;
+
+        topologyChanged();
+        return true;
     }
 
     void removeConnection (int srcId, int dstId)
@@ -151,7 +342,11 @@ public:
                     return c.sourceNodeId == srcId && c.destNodeId == dstId;
                 }),
             connections.end());
-        rebuildTopologicalSort();
+
+        // Dropping an edge never invalidates the current order
+        eraseAll (successors[srcId], dstId);
+        eraseAll (predecessors[dstId], srcId);
+        topologyChanged();
     }
 
     //==============================================================================
@@ -167,14 +362,18 @@ public:
         return (it != nodes.end()) ? it->second.get() : nullptr;
     }
 
-    const std::map<int, std::unique_ptr<AudioNode>>& getNodes() const { return nodes; }
+    const std::map<int, std::shared_ptr<AudioNode>>& getNodes() const { return nodes; }
     const std::vector<NodeConnection>& getConnections() const { return connections; }
     const std::vector<int>& getSortedNodeIds() const { return sortedNodeIds; }
 
+    /** The node whose output is the graph's, or -1 when the graph is empty. */
+    int getOutputNodeId() const noexcept { return outputNodeId; }
+
     //==============================================================================
     juce::ValueTree toValueTree() const
     {
         juce::ValueTree tree ("ModuleGraph");
+        tree.setProperty ("output", outputNodeId, nullptr);
         for (auto& [id, node] : nodes)
         {
             auto nodeTree = node->toValueTree();
@@ -192,10 +391,84 @@ public:
         return tree;
     }
 
+    /**
+     * Restore a topology saved by toValueTree() in one pass: nodes are
+     * created through NodeFactory (or kept, when a node of the same id and
+     * type already exists), connections are replaced wholesale, and the
+     * graph is sorted, prepared and published exactly once.
+     */
     void fromValueTree (const juce::ValueTree& tree)
     {
-        // Rebuild graph from saved state — implementation omitted for brevity
-        // Would reconstruct node types by stored "type" property
+        std::map<int, std::shared_ptr<AudioNode>> restoredNodes;
+        std::vector<NodeConnection>                restoredConnections;
+        auto& factory = NodeFactory::getInstance();
+
+        for (const auto& child : tree)
+        {
+            if (child.hasType ("Node"))
+            {
+                const int id = child.getProperty ("id", -1);
+                const auto type = child.getProperty ("type").toString();
+                if (id < 0 || restoredNodes.count (id) != 0)
+                    continue;
+
+                std::shared_ptr<AudioNode> node;
+                if (auto it = nodes.find (id); it != nodes.end() && it->second->getType() == type)
+                    node = it->second;
+                else if (auto created = factory.create (type, apvts))
+                    node = std::move (created);
+                else
+                    continue; // unknown type — saved by a newer build
+
+                node->setEnabled (child.getProperty ("enabled", true));
+                node->setBlockSources (parameterValues, modulationBuses, transportInfo);
+                restoredNodes[id] = std::move (node);
+            }
+            else if (child.hasType ("Connection"))
+            {
+                NodeConnection c;
+                c.sourceNodeId = child.getProperty ("src", -1);
+                c.destNodeId   = child.getProperty ("dst", -1);
+                c.weight       = child.getProperty ("w", 1.0f);
+                restoredConnections.push_back (c);
+            }
+        }
+
+        // Older states carry no topology — keep whatever is there
+        if (restoredNodes.empty())
+            return;
+
+        for (auto& [id, node] : nodes)
+            if (auto it = restoredNodes.find (id); it == restoredNodes.end() || it->second != node)
+                preparedFactors.erase (node.get());
+
+        ScopedBatch batch (*this);
+
+        nodes      = std::move (restoredNodes);
+        nextNodeId = nodes.rbegin()->first + 1;
+        connections.clear();
+        successors.clear();
+        predecessors.clear();
+
+        // Start from id order (saved graphs are mostly built front to back, so
+        // most edges need no reordering); dangling or cyclic edges are rejected
+        sortedNodeIds.clear();
+        position.clear();
+        for (auto& [id, node] : nodes)
+        {
+            position[id] = static_cast<int> (sortedNodeIds.size());
+            sortedNodeIds.push_back (id);
+        }
+
+        outputNodeId = -1;
+        for (auto& c : restoredConnections)
+            addConnection (c);
+
+        // States saved before the output was stored ended at the last sorted node
+        const int savedOutput = tree.getProperty ("output", -1);
+        outputNodeId = nodes.count (savedOutput) != 0 ? savedOutput : sortedNodeIds.back();
+
+        topologyChanged();
     }
 
     //==============================================================================
@@ -214,6 +487,8 @@ private:
     void buildDefaultGraph()
     {
         // Default serial chain: Filter → Chorus → Delay → Reverb → Distortion → SNM
+        ScopedBatch batch (*this);
+
         int filterId   = addNode (std::make_unique<GravityCurveFilter>  (apvts));
         int chorusId   = addNode (std::make_unique<SpectralWarpChorus>  (apvts));
         int delayId    = addNode (std::make_unique<PitchSmearDelay>     (apvts));
@@ -237,40 +512,810 @@ private:
         addConnection ({ freezeId,   0, mutateId,   0, 1.0f });
     }
 
-    /** Kahn's algorithm for topological sort with cycle detection. */
-    void rebuildTopologicalSort()
+    /** Publish the edit now, or once the enclosing ScopedBatch ends. */
+    void topologyChanged()
     {
-        std::map<int, int> inDegree;
-        for (auto& [id, _] : nodes) inDegree[id] = 0;
-        for (auto& c : connections)    inDegree[c.destNodeId]++;
+        if (batchDepth > 0)
+            batchDirty = true;
+        else
+            rebuildSnapshot();
+    }
 
-        std::queue<int> queue;
-        for (auto& [id, deg] : inDegree)
-            if (deg == 0) queue.push (id);
+    /**
+     * Pearce–Kelly dynamic topological order. For a new edge src → dst that
+     * points backwards in the current order, only the nodes whose positions
+     * lie between the two endpoints can be affected: those reachable from
+     * dst (forward set) and those reaching src (backward set). They are
+     * re-slotted into their own positions, backward set first. Reaching src
+     * from dst means the edge would close a cycle.
+     */
+    bool reorderForEdge (int src, int dst)
+    {
+        const int lower = position.at (dst);
+        const int upper = position.at (src);
+        if (upper < lower) return true; // already ordered
 
-        sortedNodeIds.clear();
-        while (!queue.empty())
+        std::vector<int> forward, backward;
+        std::unordered_set<int> visited { dst };
+        std::vector<int> stack { dst };
+        while (! stack.empty())
+        {
+            const int n = stack.back(); stack.pop_back();
+            forward.push_back (n);
+            for (int next : successors[n])
+            {
+                if (next == src) return false;
+                if (position.at (next) < upper && visited.insert (next).second)
+                    stack.push_back (next);
+            }
+        }
+
+        visited = { src };
+        stack   = { src };
+        while (! stack.empty())
         {
-            int n = queue.front(); queue.pop();
-            sortedNodeIds.push_back (n);
-            for (auto& c : connections)
-                if (c.sourceNodeId == n && --inDegree[c.destNodeId] == 0)
-                    queue.push (c.destNodeId);
+            const int n = stack.back(); stack.pop_back();
+            backward.push_back (n);
+            for (int prev : predecessors[n])
+                if (position.at (prev) > lower && visited.insert (prev).second)
+                    stack.push_back (prev);
         }
+
+        auto byPosition = [this] (int a, int b) { return position.at (a) < position.at (b); };
+        std::sort (forward.begin(),  forward.end(),  byPosition);
+        std::sort (backward.begin(), backward.end(), byPosition);
+
+        std::vector<int> slots;
+        for (int n : backward) slots.push_back (position.at (n));
+        for (int n : forward)  slots.push_back (position.at (n));
+        std::sort (slots.begin(), slots.end());
+
+        size_t k = 0;
+        for (auto* set : { &backward, &forward })
+            for (int n : *set)
+            {
+                const int slot = slots[k++];
+                position[n] = slot;
+                sortedNodeIds[static_cast<size_t> (slot)] = n;
+            }
+
+        return true;
+    }
+
+    static void eraseAll (std::vector<int>& v, int value)
+    {
+        v.erase (std::remove (v.begin(), v.end(), value), v.end());
+    }
+
+    /**
+     * Flatten sorted nodes + connections into a dense RenderPlan. Nodes that
+     * want oversampling are grouped into regions: a node joins its source's
+     * region when that source feeds it alone, at unit weight, and nothing
+     * else reads the source.
+     */
+    RenderPlan compileRenderPlan() const
+    {
+        RenderPlan newPlan;
+        const int numNodes = static_cast<int> (sortedNodeIds.size());
+        const int maxFactor = getOversamplingSetting();
+
+        std::map<int, int> nodeIndexOf;
+        for (int i = 0; i < numNodes; ++i)
+            nodeIndexOf[sortedNodeIds[static_cast<size_t> (i)]] = i;
+
+        // Upstream feeds per node; the first node in sorted order takes the main input
+        std::vector<std::vector<RenderInput>> nodeFeeds (static_cast<size_t> (numNodes));
+        std::vector<int> numReaders (static_cast<size_t> (numNodes), 0);
+        if (numNodes > 0)
+            nodeFeeds[0].push_back ({ RenderPlan::MAIN_SLOT, 1.0f, -1 });
+
+        for (auto& c : connections)
+        {
+            auto src = nodeIndexOf.find (c.sourceNodeId);
+            auto dst = nodeIndexOf.find (c.destNodeId);
+            if (src == nodeIndexOf.end() || dst == nodeIndexOf.end())
+                continue; // connections only ever join existing nodes
+            nodeFeeds[static_cast<size_t> (dst->second)].push_back ({ -1, c.weight, src->second });
+            ++numReaders[static_cast<size_t> (src->second)];
+        }
+
+        // Group nodes into steps
+        std::vector<std::vector<int>> members;
+        std::vector<int> factors, stepOfNode (static_cast<size_t> (numNodes), -1);
+        for (int i = 0; i < numNodes; ++i)
+        {
+            const int factor = juce::jmin (maxFactor, nodes.at (sortedNodeIds[static_cast<size_t> (i)])->getOversamplingFactor());
+            const auto& in = nodeFeeds[static_cast<size_t> (i)];
+            int step = -1;
+
+            if (factor > 1 && in.size() == 1 && in[0].sourceStep >= 0 && in[0].weight == 1.0f
+                && numReaders[static_cast<size_t> (in[0].sourceStep)] == 1)
+            {
+                const int candidate = stepOfNode[static_cast<size_t> (in[0].sourceStep)];
+                if (factors[static_cast<size_t> (candidate)] > 1)
+                    step = candidate;
+            }
+
+            if (step < 0)
+            {
+                step = static_cast<int> (members.size());
+                members.emplace_back();
+                factors.push_back (1);
+            }
+
+            members[static_cast<size_t> (step)].push_back (i);
+            factors[static_cast<size_t> (step)] = juce::jmax (factors[static_cast<size_t> (step)], factor);
+            stepOfNode[static_cast<size_t> (i)] = step;
+        }
+
+        // A step reads what its first node reads, remapped from nodes to steps
+        std::vector<std::vector<RenderInput>> feeds (members.size());
+        for (size_t k = 0; k < members.size(); ++k)
+        {
+            RenderStep step;
+            step.firstNode    = static_cast<int> (newPlan.nodes.size());
+            step.numNodes     = static_cast<int> (members[k].size());
+            step.oversampling = factors[k];
+            for (int i : members[k])
+                newPlan.nodes.push_back (nodes.at (sortedNodeIds[static_cast<size_t> (i)]).get());
+            newPlan.steps.push_back (step);
+
+            for (auto f : nodeFeeds[static_cast<size_t> (members[k].front())])
+            {
+                if (f.sourceStep >= 0)
+                    f.sourceStep = stepOfNode[static_cast<size_t> (f.sourceStep)];
+                feeds[k].push_back (f);
+            }
+        }
+
+        const auto output    = nodeIndexOf.find (outputNodeId);
+        const int outputStep = output != nodeIndexOf.end() ? stepOfNode[static_cast<size_t> (output->second)] : -1;
+        assignBufferSlots (newPlan, feeds, outputStep);
+        compileSchedule (newPlan);
+        return newPlan;
+    }
+
+    /**
+     * Liveness-based slot allocation. A slot may be rewritten by step j only
+     * when its current value's producer and every reader are ancestors of j,
+     * which keeps reuse safe under any parallel schedule as well as serially.
+     */
+    static void assignBufferSlots (RenderPlan& p, const std::vector<std::vector<RenderInput>>& feeds,
+                                   int outputStep)
+    {
+        const int numSteps = static_cast<int> (p.steps.size());
+        const auto n = static_cast<size_t> (numSteps);
+
+        // Readers of each step's output; the main input is read by step 0 only.
+        // The graph output is also read by a virtual step after the last one.
+        std::vector<std::vector<int>> readers (n);
+        for (int j = 0; j < numSteps; ++j)
+            for (auto& f : feeds[static_cast<size_t> (j)])
+                if (f.sourceStep >= 0)
+                    readers[static_cast<size_t> (f.sourceStep)].push_back (j);
+        if (outputStep >= 0)
+            readers[static_cast<size_t> (outputStep)].push_back (numSteps);
+        const std::vector<int> mainReaders { 0 };
+
+        // ancestors[j][k] — step k always completes before step j starts
+        std::vector<std::vector<bool>> ancestors (n, std::vector<bool> (n, false));
+        for (size_t j = 0; j < n; ++j)
+            for (auto& f : feeds[j])
+                if (f.sourceStep >= 0)
+                {
+                    const auto src = static_cast<size_t> (f.sourceStep);
+                    ancestors[j][src] = true;
+                    for (size_t k = 0; k < src; ++k)
+                        if (ancestors[src][k]) ancestors[j][k] = true;
+                }
+
+        auto runsBefore = [&] (int step, int j)
+        {
+            return step < 0 || (step < numSteps && ancestors[static_cast<size_t> (j)][static_cast<size_t> (step)]);
+        };
+        auto readersOf  = [&] (int step) -> const std::vector<int>& { return step < 0 ? mainReaders : readers[static_cast<size_t> (step)]; };
+
+        std::vector<int> slotValue { -1 };             // producing step per slot, -1 = main input
+        std::vector<int> slotOfStep (n, -1);
+        auto slotOfValue = [&] (int step) { return step < 0 ? RenderPlan::MAIN_SLOT : slotOfStep[static_cast<size_t> (step)]; };
+
+        for (int j = 0; j < numSteps; ++j)
+        {
+            const auto& in = feeds[static_cast<size_t> (j)];
+            auto& step = p.steps[static_cast<size_t> (j)];
+            int slot = -1;
+
+            // In place: step j is the last reader of input 0 and reads it only once
+            if (! in.empty())
+            {
+                const int v = in[0].sourceStep;
+                const bool lastReader = std::all_of (readersOf (v).begin(), readersOf (v).end(),
+                                                     [&] (int r) { return r == j || runsBefore (r, j); });
+                const bool readOnce = std::count_if (in.begin(), in.end(),
+                                                     [v] (const RenderInput& f) { return f.sourceStep == v; }) == 1;
+                if (lastReader && readOnce)
+                {
+                    slot = slotOfValue (v);
+                    step.inPlace = true;
+                }
+            }
+
+            // Otherwise the lowest dead slot (slot 0 first), or a fresh one
+            for (int s = 0; slot < 0 && s < static_cast<int> (slotValue.size()); ++s)
+            {
+                const int v = slotValue[static_cast<size_t> (s)];
+                if (runsBefore (v, j)
+                    && std::all_of (readersOf (v).begin(), readersOf (v).end(),
+                                    [&] (int r) { return runsBefore (r, j); }))
+                    slot = s;
+            }
+
+            if (slot < 0)
+            {
+                slot = static_cast<int> (slotValue.size());
+                slotValue.push_back (-1);
+            }
+
+            slotValue[static_cast<size_t> (slot)] = j;
+            slotOfStep[static_cast<size_t> (j)] = slot;
+
+            step.outputSlot = slot;
+            step.firstInput = static_cast<int> (p.inputs.size());
+            step.numInputs  = static_cast<int> (in.size());
+            for (auto f : in)
+            {
+                f.slot = slotOfValue (f.sourceStep);
+                p.inputs.push_back (f);
+            }
+        }
+
+        p.numSlots   = static_cast<int> (slotValue.size());
+        p.outputSlot = outputStep >= 0 ? slotOfStep[static_cast<size_t> (outputStep)] : RenderPlan::MAIN_SLOT;
+    }
+
+    /** Derive per-step dependency counts, dependent lists and DAG width. */
+    static void compileSchedule (RenderPlan& p)
+    {
+        const int numSteps = static_cast<int> (p.steps.size());
+        std::vector<std::vector<int>> out (static_cast<size_t> (numSteps));
+        p.numDeps.assign (static_cast<size_t> (numSteps), 0);
+
+        for (int i = 0; i < numSteps; ++i)
+        {
+            const auto& step = p.steps[static_cast<size_t> (i)];
+            std::vector<int> sources;
+            for (int k = 0; k < step.numInputs; ++k)
+                if (const int src = p.inputs[static_cast<size_t> (step.firstInput + k)].sourceStep; src >= 0)
+                    sources.push_back (src);
+
+            std::sort (sources.begin(), sources.end());
+            sources.erase (std::unique (sources.begin(), sources.end()), sources.end());
+
+            p.numDeps[static_cast<size_t> (i)] = static_cast<int> (sources.size());
+            for (int src : sources)
+                out[static_cast<size_t> (src)].push_back (i);
+        }
+
+        p.firstDependent.clear(); p.numDependents.clear(); p.dependents.clear();
+        for (auto& d : out)
+        {
+            p.firstDependent.push_back (static_cast<int> (p.dependents.size()));
+            p.numDependents.push_back (static_cast<int> (d.size()));
+            p.dependents.insert (p.dependents.end(), d.begin(), d.end());
+        }
+
+        // Longest-path level of each step; the widest level bounds useful threads
+        std::vector<int> level (static_cast<size_t> (numSteps), 0);
+        std::map<int, int> levelWidth;
+        for (int i = 0; i < numSteps; ++i)
+        {
+            const int l = level[static_cast<size_t> (i)];
+            ++levelWidth[l];
+            for (int d : out[static_cast<size_t> (i)])
+                level[static_cast<size_t> (d)] = juce::jmax (level[static_cast<size_t> (d)], l + 1);
+        }
+
+        p.maxParallelism = 1;
+        for (auto& [l, width] : levelWidth)
+            p.maxParallelism = juce::jmax (p.maxParallelism, width);
+        if (numSteps > GraphWorkerPool::MAX_TASKS)
+            p.maxParallelism = 1;
+    }
+
+    //==============================================================================
+    /** Audio thread: bind the main block to slot 0 and render the active plan. */
+    void renderActiveSnapshot (juce::dsp::AudioBlock<float>& mainBlock)
+    {
+        auto& snap = *activeSnapshot;
+        if (snap.plan.steps.empty()) return;
+
+        snap.blockSamples  = static_cast<int> (mainBlock.getNumSamples());
+        snap.blockChannels = juce::jmin (snap.numChannels, static_cast<int> (mainBlock.getNumChannels()));
+        jassert (snap.blockSamples <= snap.maxSamples);
+
+        for (int ch = 0; ch < snap.blockChannels; ++ch)
+            snap.slotChannels[static_cast<size_t> (ch)] = mainBlock.getChannelPointer (static_cast<size_t> (ch));
+
+        if (snap.staticChain != nullptr)
+        {
+            snap.staticChain->render ({ snap.getSlot (RenderPlan::MAIN_SLOT), snap.blockChannels,
+                                        snap.blockSamples, snap.sampleRate, snap.oversamplers.data() });
+            return;
+        }
+
+        if (snap.plan.maxParallelism > 1 && workerPool.getNumWorkers() > 0)
+            renderSnapshotParallel (snap);
+        else
+            renderSnapshot (snap);
+
+        copyPlanOutput (snap);
+    }
+
+    /** Audio thread: record the latency the block just carried, from each node's block latency. */
+    static void updateRenderedLatency (GraphSnapshot& snap) noexcept
+    {
+        const int latency = measureLatency (snap, snap.stepLatency.data(),
+                                            [] (const AudioNode& node) { return node.getBlockLatencySamples(); });
+        snap.renderedLatency.store (latency, std::memory_order_relaxed);
+    }
+
+    /** Audio thread: run one snapshot's plan serially. */
+    static void renderSnapshot (GraphSnapshot& snap)
+    {
+        const int numSteps = static_cast<int> (snap.plan.steps.size());
+        for (int i = 0; i < numSteps; ++i)
+            renderStep (snap, i);
+    }
+
+    /** Audio thread: same as renderSnapshot, with independent steps spread over the pool. */
+    void renderSnapshotParallel (GraphSnapshot& snap)
+    {
+        const auto& p = snap.plan;
+
+        TaskGraphView view;
+        view.numTasks       = static_cast<int> (p.steps.size());
+        view.numDeps        = p.numDeps.data();
+        view.firstDependent = p.firstDependent.data();
+        view.numDependents  = p.numDependents.data();
+        view.dependents     = p.dependents.data();
+        view.pendingDeps    = snap.pendingDeps.get();
+
+        workerPool.run (view, [] (void* context, int task)
+        {
+            renderStep (*static_cast<GraphSnapshot*> (context), task);
+        }, &snap);
+    }
+
+    /** Mix one step's inputs into its output slot and process its nodes. */
+    static void renderStep (GraphSnapshot& snap, int stepIndex)
+    {
+        using FVO = juce::FloatVectorOperations;
+        const auto& step   = snap.plan.steps[static_cast<size_t> (stepIndex)];
+        const int samples  = snap.blockSamples;
+        const int channels = snap.blockChannels;
+        float* const* out  = snap.getSlot (step.outputSlot);
+        const RenderInput* inputs = snap.plan.inputs.data() + step.firstInput;
+
+        // Seed the output from input 0 (in place when possible), then sum the rest
+        if (step.numInputs == 0)
+        {
+            for (int ch = 0; ch < channels; ++ch)
+                FVO::clear (out[ch], samples);
+        }
+        else if (step.inPlace)
+        {
+            if (inputs[0].weight != 1.0f)
+                for (int ch = 0; ch < channels; ++ch)
+                    FVO::multiply (out[ch], inputs[0].weight, samples);
+        }
+        else
+        {
+            float* const* in = snap.getSlot (inputs[0].slot);
+            for (int ch = 0; ch < channels; ++ch)
+                FVO::copyWithMultiply (out[ch], in[ch], inputs[0].weight, samples);
+        }
+
+        for (int i = 1; i < step.numInputs; ++i)
+        {
+            float* const* in = snap.getSlot (inputs[i].slot);
+            for (int ch = 0; ch < channels; ++ch)
+                FVO::addWithMultiply (out[ch], in[ch], inputs[i].weight, samples);
+        }
+
+        // A sleeping step's input is silence, and so is its output
+        AudioNode* const* stepNodes = snap.plan.nodes.data() + step.firstNode;
+        if (StepRunner::shouldSleep (stepNodes, step.numNodes, step.oversampling,
+                                     out, channels, samples, snap.sampleRate))
+        {
+            for (int k = 0; k < step.numNodes; ++k)
+                stepNodes[k]->getProfileStats().recordSkip();
+            return;
+        }
+
+        if (auto* os = snap.oversamplers[static_cast<size_t> (stepIndex)].get())
+        {
+            juce::dsp::AudioBlock<float> block (out, static_cast<size_t> (channels),
+                                                static_cast<size_t> (samples));
+            auto upsampled = os->processSamplesUp (block);
+            float* upChannels[NodeContext::MAX_CHANNELS] {};
+            const int numUpChannels = NodeContext::gatherChannels (upsampled, upChannels);
+            renderNodes (stepNodes, step.numNodes, upChannels, numUpChannels,
+                         static_cast<int> (upsampled.getNumSamples()), samples);
+            os->processSamplesDown (block);
+        }
+        else
+        {
+            renderNodes (stepNodes, step.numNodes, out, channels, samples, samples);
+        }
+    }
+
+    /** Run a step's nodes in order through the dynamic (virtual) path. */
+    static void renderNodes (AudioNode* const* stepNodes, int numNodes, float* const* channels,
+                             int numChannels, int numSamples, int baseSamples)
+    {
+        for (int k = 0; k < numNodes; ++k)
+            StepRunner::run (*stepNodes[k], channels, numChannels, numSamples, baseSamples);
+    }
+
+    /** Copy the sink's output into the main block unless it already lives there. */
+    static void copyPlanOutput (const GraphSnapshot& snap)
+    {
+        if (snap.plan.outputSlot == RenderPlan::MAIN_SLOT) return;
+
+        float* const* main = snap.getSlot (RenderPlan::MAIN_SLOT);
+        float* const* out  = snap.getSlot (snap.plan.outputSlot);
+        for (int ch = 0; ch < snap.blockChannels; ++ch)
+            juce::FloatVectorOperations::copy (main[ch], out[ch], snap.blockSamples);
+    }
+
+    //==============================================================================
+    /** Message thread: compile the current model into a snapshot and publish it. */
+    void rebuildSnapshot()
+    {
+        auto snap = std::make_unique<GraphSnapshot>();
+        snap->plan        = compileRenderPlan();
+        snap->numChannels = numChannels;
+        snap->isPrepared  = isPrepared;
+        compiledOversampling = getOversamplingSetting();
+
+        if (isPrepared)
+            prepareNodesForPlan (snap->plan);
+
+        for (auto& [id, node] : nodes)
+            snap->nodeRefs.push_back (node);
+
+        snap->maxSamples  = blockSize;
+        snap->sampleRate  = sampleRate;
+
+        // Scratch only for slots beyond the main block — a serial chain needs none
+        if (isPrepared)
+        {
+            snap->buffers.resize (static_cast<size_t> (snap->plan.numSlots - 1));
+            for (auto& buf : snap->buffers)
+                buf.setSize (numChannels, blockSize);
+
+            snap->slotChannels.assign (static_cast<size_t> (snap->plan.numSlots * numChannels), nullptr);
+            for (int slot = 1; slot < snap->plan.numSlots; ++slot)
+                for (int ch = 0; ch < numChannels; ++ch)
+                    snap->slotChannels[static_cast<size_t> (slot * numChannels + ch)]
+                        = snap->buffers[static_cast<size_t> (slot - 1)].getWritePointer (ch);
+        }
+
+        const int numSteps = static_cast<int> (snap->plan.steps.size());
+        snap->pendingDeps = std::make_unique<std::atomic<int>[]> (static_cast<size_t> (juce::jmax (1, numSteps)));
+
+        // One resampler per oversampled region
+        snap->oversamplers.resize (static_cast<size_t> (numSteps));
+        if (isPrepared)
+            for (int i = 0; i < numSteps; ++i)
+                if (const int factor = snap->plan.steps[static_cast<size_t> (i)].oversampling; factor > 1)
+                {
+                    auto& os = snap->oversamplers[static_cast<size_t> (i)];
+                    os = std::make_unique<OversamplingChain> (factor, numChannels);
+                    os->prepare (getProcessSpec());
+                }
+
+        snap->latency = computeLatency (*snap);
+        snap->stepLatency.assign (static_cast<size_t> (numSteps), 0.0f);
+        snap->renderedLatency.store (snap->latency, std::memory_order_relaxed);
+
+        // The default topology renders through its devirtualised chain
+        if (isPrepared && isSerialInPlaceChain (snap->plan))
+            snap->staticChain = DefaultChain::tryCreate (snap->plan.nodes);
+
+        // Spin up helpers only once a graph actually has parallel branches
+        if (isPrepared && snap->plan.maxParallelism > 1)
+            workerPool.ensureWorkers (juce::jmin (snap->plan.maxParallelism,
+                                                  juce::SystemStats::getNumCpus()) - 1);
+
+        const int newLatency = snap->latency;
+        tailSeconds.store (computeTail (*snap), std::memory_order_relaxed);
+        publishSnapshot (std::move (snap));
+
+        if (isPrepared && newLatency != getLatencySamples())
+        {
+            latencySamples.store (newLatency, std::memory_order_relaxed);
+            if (onLatencyChanged != nullptr)
+                onLatencyChanged (newLatency);
+        }
+    }
+
+    /**
+     * Message thread: latency along the longest path to the output, in
+     * base-rate samples, from what the nodes report. Node latency can
+     * change with parameters, so this is re-evaluated by the timer as well
+     * as on every rebuild.
+     */
+    static int computeLatency (const GraphSnapshot& snap)
+    {
+        std::vector<float> stepLatency (snap.plan.steps.size(), 0.0f);
+        return measureLatency (snap, stepLatency.data(),
+                               [] (const AudioNode& node) { return node.getLatencySamples(); });
+    }
+
+    /**
+     * Latency along the longest path to the output, in base-rate samples:
+     * each region's resampler plus its nodes' latency (as nodeLatency
+     * reads it), scaled down from the region's rate. stepLatency holds one
+     * float per step, so the audio thread can run this on snapshot scratch.
+     */
+    template <typename NodeLatency>
+    static int measureLatency (const GraphSnapshot& snap, float* stepLatency, NodeLatency&& nodeLatencyOf)
+    {
+        const auto& plan = snap.plan;
+        const int numSteps = static_cast<int> (plan.steps.size());
+        int result = 0;
+
+        for (int i = 0; i < numSteps; ++i)
+        {
+            const auto& step = plan.steps[static_cast<size_t> (i)];
+            float latency = 0.0f;
+            for (int k = 0; k < step.numInputs; ++k)
+                if (const int src = plan.inputs[static_cast<size_t> (step.firstInput + k)].sourceStep; src >= 0)
+                    latency = juce::jmax (latency, stepLatency[src]);
+
+            if (const auto& os = snap.oversamplers[static_cast<size_t> (i)])
+                latency += os->getLatencyInSamples();
+
+            int nodeLatency = 0;
+            for (int n = 0; n < step.numNodes; ++n)
+                nodeLatency += nodeLatencyOf (*plan.nodes[static_cast<size_t> (step.firstNode + n)]);
+            latency += static_cast<float> (nodeLatency) / static_cast<float> (step.oversampling);
+
+            stepLatency[i] = latency;
+            if (step.outputSlot == plan.outputSlot)
+                result = juce::roundToInt (latency);
+        }
+
+        return result;
+    }
+
+    /**
+     * Message thread: how long the graph can ring after its input stops.
+     * Nodes in series ring one after another, so tails add along a path and
+     * the longest path to the output wins. Tails follow parameters (reverb
+     * decay, delay feedback), so the timer re-evaluates this with latency.
+     */
+    static double computeTail (const GraphSnapshot& snap)
+    {
+        const auto& plan = snap.plan;
+        const int numSteps = static_cast<int> (plan.steps.size());
+        std::vector<double> stepTail (static_cast<size_t> (numSteps), 0.0);
+        double result = 0.0;
+
+        for (int i = 0; i < numSteps; ++i)
+        {
+            const auto& step = plan.steps[static_cast<size_t> (i)];
+            double tail = 0.0;
+            for (int k = 0; k < step.numInputs; ++k)
+                if (const int src = plan.inputs[static_cast<size_t> (step.firstInput + k)].sourceStep; src >= 0)
+                    tail = juce::jmax (tail, stepTail[static_cast<size_t> (src)]);
+
+            for (int n = 0; n < step.numNodes; ++n)
+                tail += plan.nodes[static_cast<size_t> (step.firstNode + n)]->getTailLengthSeconds (nullptr, nullptr);
+
+            stepTail[static_cast<size_t> (i)] = tail;
+            if (step.outputSlot == plan.outputSlot)
+                result = tail;
+        }
+
+        return result;
+    }
+
+    /** True when every step is one node, fed only by the previous step, in the main block. */
+    static bool isSerialInPlaceChain (const RenderPlan& p)
+    {
+        if (p.outputSlot != RenderPlan::MAIN_SLOT)
+            return false;
+
+        for (int i = 0; i < static_cast<int> (p.steps.size()); ++i)
+        {
+            const auto& step = p.steps[static_cast<size_t> (i)];
+            if (step.numNodes != 1 || step.numInputs != 1 || ! step.inPlace
+                || step.outputSlot != RenderPlan::MAIN_SLOT)
+                return false;
+
+            const auto& in = p.inputs[static_cast<size_t> (step.firstInput)];
+            if (in.sourceStep != i - 1 || in.weight != 1.0f)
+                return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * Message thread: prepare every node at its region's rate. A node that
+     * has never been prepared can't be in a published snapshot, so it is
+     * prepared in place. One that a published snapshot may be rendering is
+     * left alone: a fresh instance takes its id, is prepared here, and goes
+     * live with this plan. The old instance keeps playing until the audio
+     * thread adopts the new snapshot, then dies with the last snapshot that
+     * holds it.
+     */
+    void prepareNodesForPlan (RenderPlan& p)
+    {
+        for (auto& step : p.steps)
+            for (int k = 0; k < step.numNodes; ++k)
+            {
+                auto*& node = p.nodes[static_cast<size_t> (step.firstNode + k)];
+                auto it = preparedFactors.find (node);
+                if (it != preparedFactors.end() && it->second == step.oversampling)
+                    continue;
+
+                if (it != preparedFactors.end())
+                {
+                    auto* fresh = replaceWithFreshInstance (*node);
+                    if (fresh == nullptr)
+                    {
+                        jassertfalse; // addNode() only accepts types NodeFactory can create
+                        continue;
+                    }
+
+                    preparedFactors.erase (it);
+                    node = fresh;
+                }
+
+                node->prepare (getProcessSpec (step.oversampling));
+                preparedFactors[node] = step.oversampling;
+            }
+    }
+
+    /**
+     * Message thread: swap an unprepared copy of a node into the model under
+     * the same id. Parameters live in the APVTS, so the type, the enable
+     * switch and the canvas placement are all a copy needs.
+     */
+    AudioNode* replaceWithFreshInstance (const AudioNode& old)
+    {
+        for (auto& [id, node] : nodes)
+        {
+            if (node.get() != &old)
+                continue;
+
+            std::shared_ptr<AudioNode> fresh = NodeFactory::getInstance().create (old.getType(), apvts);
+            if (fresh == nullptr)
+                return nullptr;
+
+            fresh->setEnabled (old.isEnabled());
+            fresh->canvasPosition = old.canvasPosition;
+            fresh->orb_colour     = old.orb_colour;
+            fresh->setBlockSources (parameterValues, modulationBuses, transportInfo);
+            node = std::move (fresh);
+            return node.get();
+        }
+
+        return nullptr;
+    }
+
+    void publishSnapshot (std::unique_ptr<GraphSnapshot> snap)
+    {
+        snap->generation = ++lastPublishedGeneration;
+        auto* raw = snap.get();
+        liveSnapshots.push_back (std::move (snap));
+
+        // A pending snapshot the audio thread never adopted can be dropped at once
+        if (auto* superseded = pendingSnapshot.exchange (raw, std::memory_order_acq_rel))
+            eraseSnapshot (superseded);
+
+        reclaimRetiredSnapshots();
+    }
+
+    /** Frees every snapshot older than the one the audio thread last adopted. */
+    void reclaimRetiredSnapshots()
+    {
+        const auto adopted = adoptedGeneration.load (std::memory_order_acquire);
+        liveSnapshots.erase (
+            std::remove_if (liveSnapshots.begin(), liveSnapshots.end(),
+                [adopted](const std::unique_ptr<GraphSnapshot>& s) {
+                    return s->generation < adopted;
+                }),
+            liveSnapshots.end());
+    }
+
+    void eraseSnapshot (GraphSnapshot* snap)
+    {
+        liveSnapshots.erase (
+            std::remove_if (liveSnapshots.begin(), liveSnapshots.end(),
+                [snap](const std::unique_ptr<GraphSnapshot>& s) { return s.get() == snap; }),
+            liveSnapshots.end());
+    }
+
+    void timerCallback() override
+    {
+        // The Oversampling choice is polled rather than listened to: changing
+        // it re-prepares nodes, which must never happen on the audio thread
+        if (isPrepared && getOversamplingSetting() != compiledOversampling)
+            rebuildSnapshot();
+
+        // Nodes such as SpectralWarpChorus change their latency with a parameter,
+        // and tails follow decay and feedback settings. This only keeps the host's
+        // compensation current; the dry path follows getRenderedLatencySamples()
+        if (isPrepared && ! liveSnapshots.empty())
+            if (const int latency = computeLatency (*liveSnapshots.back()); latency != getLatencySamples())
+            {
+                latencySamples.store (latency, std::memory_order_relaxed);
+                if (onLatencyChanged != nullptr)
+                    onLatencyChanged (latency);
+            }
+
+        if (! liveSnapshots.empty())
+            tailSeconds.store (computeTail (*liveSnapshots.back()), std::memory_order_relaxed);
+
+        reclaimRetiredSnapshots();
+    }
+
+    /** Highest factor any region may use, from the Oversampling choice (1x/2x/4x/8x). */
+    int getOversamplingSetting() const
+    {
+        const int index = static_cast<int> (apvts.getRawParameterValue (ParamID::OVERSAMPLE)->load());
+        return 1 << juce::jlimit (0, 3, index);
+    }
+
+    juce::dsp::ProcessSpec getProcessSpec (int factor = 1) const
+    {
+        return { sampleRate * factor,
+                 static_cast<juce::uint32> (blockSize * factor),
+                 static_cast<juce::uint32> (numChannels) };
     }
 
     //==============================================================================
     juce::AudioProcessorValueTreeState& apvts;
 
-    std::map<int, std::unique_ptr<AudioNode>>   nodes;
-    std::map<int, juce::AudioBuffer<float>>     nodeBuffers;
+    // Editable model — message thread only
+    std::map<int, std::shared_ptr<AudioNode>>   nodes;
     std::vector<NodeConnection>                  connections;
-    std::vector<int>                             sortedNodeIds;
+    std::vector<int>                             sortedNodeIds;    // topological order
+    std::unordered_map<int, int>                 position;         // node id → index in sortedNodeIds
+    std::unordered_map<int, std::vector<int>>    successors, predecessors;
+    int                                          batchDepth { 0 };
+    bool                                         batchDirty { false };
+
+    // Snapshot hand-off: message thread owns liveSnapshots, audio thread
+    // owns activeSnapshot, the two atomics are the only shared state.
+    std::vector<std::unique_ptr<GraphSnapshot>>  liveSnapshots;
+    std::atomic<GraphSnapshot*>                  pendingSnapshot   { nullptr };
+    std::atomic<juce::uint64>                    adoptedGeneration { 0 };
+    GraphSnapshot*                               activeSnapshot    { nullptr };
+    juce::uint64                                 lastPublishedGeneration { 0 };
+
+    // Rate each node was last prepared at — message thread only
+    std::map<const AudioNode*, int>              preparedFactors;
+    int                                          compiledOversampling { 1 };
+    std::atomic<int>                             latencySamples       { 0 };
+    std::atomic<double>                          tailSeconds          { 0.0 };
+
+    GraphWorkerPool                              workerPool;
+
+    const ParameterValues*                       parameterValues { nullptr };
+    const ModulationBuses*                       modulationBuses { nullptr };
+    const TransportInfo*                         transportInfo   { nullptr };
 
-    int nextNodeId  { 0 };
-    double sampleRate  { 44100.0 };
-    int    blockSize   { 512 };
-    int    numChannels { 2 };
+    int    nextNodeId   { 0 };
+    int    outputNodeId { -1 }; // set explicitly, never by insertion order
+    bool   isPrepared   { false };
+    double sampleRate   { 44100.0 };
+    int    blockSize    { 512 };
+    int    numChannels  { 2 };
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ModuleGraph)
 };
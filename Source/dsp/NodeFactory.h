@@ -0,0 +1,108 @@
+#pragma once
+#include <JuceHeader.h>
+#include "AudioNode.h"
+#include "modules/SpectralWarpChorus.h"
+#include "modules/PortalReverb.h"
+#include "modules/PitchSmearDelay.h"
+#include "modules/Harmonic808Inflator.h"
+#include "modules/GravityCurveFilter.h"
+#include "modules/PlasmaDistortion.h"
+#include "modules/StereoNeuralMotion.h"
+#include "modules/TextureGenerator.h"
+#include "modules/FreezeCapture.h"
+#include "modules/MutationEngine.h"
+
+//==============================================================================
+/**
+ * NodeFactory
+ *
+ * Maps the type strings written by AudioNode::getType() back to
+ * constructors, so ModuleGraph::fromValueTree can rebuild any saved
+ * topology. The built-in modules are registered once on first use; the
+ * table is a sorted vector, so a lookup is a binary search with no
+ * allocation.
+ */
+class NodeFactory
+{
+public:
+    using Creator = std::unique_ptr<AudioNode> (*) (juce::AudioProcessorValueTreeState&);
+
+    /** The process-wide registry, pre-filled with every SNOT module. */
+    static NodeFactory& getInstance()
+    {
+        static NodeFactory instance;
+        return instance;
+    }
+
+    /** Register (or replace) the creator for a type string. Message thread only. */
+    void registerType (const juce::String& type, Creator creator)
+    {
+        auto it = lowerBound (type);
+        if (it != entries.end() && it->type == type)
+            it->creator = creator;
+        else
+            entries.insert (it, { type, creator });
+    }
+
+    /** Construct a node of the given type, or nullptr if the type is unknown. */
+    std::unique_ptr<AudioNode> create (const juce::String& type,
+                                       juce::AudioProcessorValueTreeState& apvts) const
+    {
+        auto it = lowerBound (type);
+        if (it == entries.end() || it->type != type)
+            return nullptr;
+        return it->creator (apvts);
+    }
+
+    bool isRegistered (const juce::String& type) const
+    {
+        auto it = lowerBound (type);
+        return it != entries.end() && it->type == type;
+    }
+
+private:
+    NodeFactory()
+    {
+        registerBuiltIn<GravityCurveFilter>   ("gravity_filter");
+        registerBuiltIn<SpectralWarpChorus>   ("spectral_warp_chorus");
+        registerBuiltIn<PitchSmearDelay>      ("pitch_smear_delay");
+        registerBuiltIn<PortalReverb>         ("portal_reverb");
+        registerBuiltIn<PlasmaDistortion>     ("plasma_distortion");
+        registerBuiltIn<StereoNeuralMotion>   ("stereo_neural_motion");
+        registerBuiltIn<Harmonic808Inflator>  ("harmonic_808_inflator");
+        registerBuiltIn<TextureGenerator>     ("texture_generator");
+        registerBuiltIn<FreezeCapture>        ("freeze_capture");
+        registerBuiltIn<MutationEngine>       ("mutation_engine");
+    }
+
+    template <typename NodeType>
+    void registerBuiltIn (const char* type)
+    {
+        registerType (type, [] (juce::AudioProcessorValueTreeState& apvts) -> std::unique_ptr<AudioNode>
+        {
+            return std::make_unique<NodeType> (apvts);
+        });
+    }
+
+    struct Entry
+    {
+        juce::String type;
+        Creator      creator { nullptr };
+    };
+
+    std::vector<Entry>::const_iterator lowerBound (const juce::String& type) const
+    {
+        return std::lower_bound (entries.begin(), entries.end(), type,
+                                 [] (const Entry& e, const juce::String& t) { return e.type < t; });
+    }
+
+    std::vector<Entry>::iterator lowerBound (const juce::String& type)
+    {
+        return std::lower_bound (entries.begin(), entries.end(), type,
+                                 [] (const Entry& e, const juce::String& t) { return e.type < t; });
+    }
+
+    std::vector<Entry> entries;
+
+    JUCE_DECLARE_NON_COPYABLE (NodeFactory)
+};
@@ -0,0 +1,154 @@
+#pragma once
+#include <JuceHeader.h>
+#include <bit>
+
+//==============================================================================
+/**
+ * SNOT_NODE_PROFILING — per-node timing in ModuleGraph.
+ * On by default; define to 0 to compile every probe out entirely.
+ */
+#ifndef SNOT_NODE_PROFILING
+ #define SNOT_NODE_PROFILING 1
+#endif
+
+//==============================================================================
+/**
+ * NodeProfileStats
+ *
+ * Lock-free timing counters for one AudioNode. The rendering thread records
+ * with relaxed atomic adds (one writer per node per block); the editor calls
+ * collect() on the message thread, which drains the timing window and
+ * returns mean and p99 ns/sample since the previous call. Call and skip
+ * counts are cumulative.
+ *
+ * p99 comes from a log histogram with four buckets per octave of
+ * ns/sample, so the figure is accurate to within 25%.
+ */
+class NodeProfileStats
+{
+public:
+    struct Summary
+    {
+        juce::uint64 calls           { 0 };
+        juce::uint64 skipped         { 0 };
+        double       meanNsPerSample { 0.0 };
+        double       p99NsPerSample  { 0.0 };
+    };
+
+    static constexpr bool isEnabled() noexcept { return SNOT_NODE_PROFILING != 0; }
+
+    //==============================================================================
+    /** Audio thread: one processed block of numSamples that took `ticks`. */
+    void recordCall (juce::int64 ticks, int numSamples) noexcept
+    {
+        if (numSamples <= 0) return;
+
+        const auto ns = static_cast<juce::uint64> (juce::jmax<juce::int64> (0, ticks)) * nsPerTickQ16() >> 16;
+        calls.fetch_add (1, std::memory_order_relaxed);
+        windowNs.fetch_add (ns, std::memory_order_relaxed);
+        windowSamples.fetch_add (static_cast<juce::uint64> (numSamples), std::memory_order_relaxed);
+        histogram[static_cast<size_t> (bucketFor (ns * 4 / static_cast<juce::uint64> (numSamples)))]
+            .fetch_add (1, std::memory_order_relaxed);
+    }
+
+    /** Audio thread: the node was bypassed or slept this block. */
+    void recordSkip() noexcept
+    {
+       #if SNOT_NODE_PROFILING
+        skipped.fetch_add (1, std::memory_order_relaxed);
+       #endif
+    }
+
+    //==============================================================================
+    /** Message thread (single reader): drain the timing window. */
+    Summary collect() noexcept
+    {
+        Summary s;
+        s.calls   = calls.load (std::memory_order_relaxed);
+        s.skipped = skipped.load (std::memory_order_relaxed);
+
+        const auto ns      = windowNs.exchange (0, std::memory_order_relaxed);
+        const auto samples = windowSamples.exchange (0, std::memory_order_relaxed);
+        if (samples > 0)
+            s.meanNsPerSample = static_cast<double> (ns) / static_cast<double> (samples);
+
+        std::array<juce::uint64, NUM_BUCKETS> counts {};
+        juce::uint64 total = 0;
+        for (size_t b = 0; b < NUM_BUCKETS; ++b)
+            total += (counts[b] = histogram[b].exchange (0, std::memory_order_relaxed));
+
+        // First bucket whose cumulative count reaches 99% of the window
+        const auto threshold = total - total / 100;
+        juce::uint64 running = 0;
+        for (size_t b = 0; b < NUM_BUCKETS && total > 0; ++b)
+            if ((running += counts[b]) >= threshold)
+            {
+                s.p99NsPerSample = bucketUpperBound (static_cast<int> (b));
+                break;
+            }
+
+        return s;
+    }
+
+private:
+    static constexpr size_t NUM_BUCKETS = 64;
+
+    /** Bucket of a ns/sample value in Q2 fixed point: octave × 4 + two mantissa bits. */
+    static int bucketFor (juce::uint64 q2) noexcept
+    {
+        if (q2 < 4) return static_cast<int> (q2);
+        const int msb  = 63 - std::countl_zero (q2);
+        const int mant = static_cast<int> ((q2 >> (msb - 2)) & 3);
+        return juce::jmin (static_cast<int> (NUM_BUCKETS) - 1, (msb - 1) * 4 + mant);
+    }
+
+    static double bucketUpperBound (int b) noexcept
+    {
+        if (b < 4) return (b + 1) * 0.25;
+        const int msb  = b / 4 + 1;
+        const int mant = b % 4;
+        return std::ldexp (static_cast<double> (4 + mant + 1), msb - 2) * 0.25;
+    }
+
+    /** Nanoseconds per high-resolution tick in Q16, fixed for the process. */
+    static juce::uint64 nsPerTickQ16() noexcept
+    {
+        static const auto q16 = static_cast<juce::uint64> (
+            65536.0e9 / static_cast<double> (juce::Time::getHighResolutionTicksPerSecond()));
+        return q16;
+    }
+
+    std::atomic<juce::uint64> calls         { 0 };
+    std::atomic<juce::uint64> skipped       { 0 };
+    std::atomic<juce::uint64> windowNs      { 0 };
+    std::atomic<juce::uint64> windowSamples { 0 };
+    std::array<std::atomic<juce::uint64>, NUM_BUCKETS> histogram {};
+};
+
+//==============================================================================
+/**
+ * ScopedNodeTimer — times its scope into a NodeProfileStats.
+ * Compiles to nothing when SNOT_NODE_PROFILING is 0.
+ */
+class ScopedNodeTimer
+{
+public:
+   #if SNOT_NODE_PROFILING
+    ScopedNodeTimer (NodeProfileStats& s, int n) noexcept
+        : stats (s), numSamples (n), start (juce::Time::getHighResolutionTicks()) {}
+
+    ~ScopedNodeTimer() noexcept
+    {
+        stats.recordCall (juce::Time::getHighResolutionTicks() - start, numSamples);
+    }
+
+private:
+    NodeProfileStats& stats;
+    const int         numSamples;
+    const juce::int64 start;
+   #else
+    ScopedNodeTimer (NodeProfileStats&, int) noexcept {}
+   #endif
+
+    JUCE_DECLARE_NON_COPYABLE (ScopedNodeTimer)
+};
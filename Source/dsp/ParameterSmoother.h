@@ -0,0 +1,158 @@
+#pragma once
+#include <JuceHeader.h>
+#include "ModulationBuses.h"
+
+//==============================================================================
+/**
+ * ParameterSmoother
+ *
+ * Smooths a node's parameters together, once per block, into per-sample
+ * ramp buffers, in place of one juce::SmoothedValue per parameter stepped
+ * in the inner loops.
+ *
+ * Each slot follows one ModulatedParameter's block-end value:
+ *   - Stable parameters cost one comparison per block. Their buffer
+ *     already holds the value, so nothing is written.
+ *   - A jump from automation or the UI becomes a linear ramp over the
+ *     slot's ramp time, however many blocks that spans. This keeps 32-sample
+ *     host buffers zipper-free.
+ *   - A modulated lane already moves continuously, so it ramps across the
+ *     block as ModulatedParameter::getRamp() does.
+ * Ramps are written with vector operations against a shared 1, 2, 3, …
+ * sequence.
+ *
+ *     // constructor
+ *     driveSlot = smoother.add (pDrive);
+ *     // render()
+ *     smoother.process (context.parameters, context.modulation, context.numSamples);
+ *     const float* drive = smoother.get (driveSlot);
+ */
+class ParameterSmoother
+{
+public:
+    static constexpr double DEFAULT_RAMP_SECONDS = 0.02;
+
+    ParameterSmoother() = default;
+
+    /** Message thread, before prepare(): smooth a parameter; returns its slot. */
+    int add (const ModulatedParameter& parameter, double rampSeconds = DEFAULT_RAMP_SECONDS)
+    {
+        Slot slot;
+        slot.parameter   = &parameter;
+        slot.rampSeconds = rampSeconds;
+        slots.push_back (slot);
+        return static_cast<int> (slots.size()) - 1;
+    }
+
+    /** Message thread: size the ramp buffers for blocks up to maxBlockSize at sampleRate. */
+    void prepare (double sampleRate, int maxBlockSize)
+    {
+        maxBlock = juce::jmax (1, maxBlockSize);
+        buffers.assign (slots.size() * static_cast<size_t> (maxBlock), 0.0f);
+
+        sequence.resize (static_cast<size_t> (maxBlock));
+        for (int i = 0; i < maxBlock; ++i)
+            sequence[static_cast<size_t> (i)] = static_cast<float> (i + 1);
+
+        for (auto& slot : slots)
+            slot.rampSamples = juce::jmax (1, juce::roundToInt (slot.rampSeconds * sampleRate));
+
+        reset();
+    }
+
+    /** The next process() jumps straight to the current values. */
+    void reset() noexcept { snapToTarget = true; }
+
+    //==============================================================================
+    /** Audio thread, at the top of the node's render(): advance every slot by numSamples. */
+    void process (const ParameterValues* values, const ModulationBuses* buses, int numSamples) noexcept
+    {
+        jassert (numSamples <= maxBlock);
+        numSamples = juce::jmin (numSamples, maxBlock);
+
+        for (size_t i = 0; i < slots.size(); ++i)
+        {
+            auto& slot = slots[i];
+            const auto v = slot.parameter->getBlockValues (values, buses);
+
+            if (snapToTarget)
+            {
+                slot.current = slot.target = v.end;
+                slot.remaining = 0;
+            }
+            else if (v.end != slot.target)
+            {
+                slot.target    = v.end;
+                slot.remaining = v.start != v.end ? numSamples : slot.rampSamples;
+                slot.step      = (slot.target - slot.current) / static_cast<float> (slot.remaining);
+            }
+
+            float* out = buffers.data() + i * static_cast<size_t> (maxBlock);
+
+            if (slot.remaining == 0)
+            {
+                // Stable: the buffer only needs writing once per new value
+                slot.constant = true;
+                if (slot.filledWith != slot.current || slot.filledLength < numSamples)
+                {
+                    juce::FloatVectorOperations::fill (out, slot.current, maxBlock);
+                    slot.filledWith   = slot.current;
+                    slot.filledLength = maxBlock;
+                }
+                continue;
+            }
+
+            const int n = juce::jmin (slot.remaining, numSamples);
+            juce::FloatVectorOperations::copyWithMultiply (out, sequence.data(), slot.step, n);
+            juce::FloatVectorOperations::add (out, slot.current, n);
+
+            slot.remaining -= n;
+            slot.current    = slot.remaining == 0 ? slot.target : out[n - 1];
+            if (n < numSamples)
+                juce::FloatVectorOperations::fill (out + n, slot.target, numSamples - n);
+
+            slot.constant     = false;
+            slot.filledLength = 0;
+        }
+
+        snapToTarget = false;
+    }
+
+    //==============================================================================
+    /** The slot's value at each sample of the block process() was given. */
+    const float* get (int slot) const noexcept
+    {
+        return buffers.data() + static_cast<size_t> (slot) * static_cast<size_t> (maxBlock);
+    }
+
+    /** The slot's value at the end of the block. */
+    float getValue (int slot) const noexcept { return slots[static_cast<size_t> (slot)].current; }
+
+    /** True when get (slot) holds getValue (slot) throughout, so per-sample work can be hoisted. */
+    bool isConstant (int slot) const noexcept { return slots[static_cast<size_t> (slot)].constant; }
+
+private:
+    struct Slot
+    {
+        const ModulatedParameter* parameter { nullptr };
+        double rampSeconds  { DEFAULT_RAMP_SECONDS };
+        int    rampSamples  { 1 };
+
+        float  current   { 0.0f };
+        float  target    { 0.0f };
+        float  step      { 0.0f };
+        int    remaining { 0 };   // samples left in the ramp
+        bool   constant  { true };
+
+        float  filledWith   { 0.0f };
+        int    filledLength { 0 };
+    };
+
+    std::vector<Slot>  slots;
+    std::vector<float> buffers;  // maxBlock floats per slot
+    std::vector<float> sequence; // 1 … maxBlock
+    int  maxBlock     { 0 };
+    bool snapToTarget { true };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ParameterSmoother)
+};
@@ -0,0 +1,101 @@
+#pragma once
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+ * ParameterValues — every parameter's raw value for one block, indexed by
+ * ParamIndex. One contiguous, cache-line-aligned array, so a node's reads
+ * are plain loads from a line or two instead of one APVTS atomic (and its
+ * heap object) per parameter.
+ */
+struct ParameterValues
+{
+    float operator[] (ParamIndex::Index i) const noexcept { return values[static_cast<size_t> (i)]; }
+
+    /** A raw value by dense index, for code that resolved an ID at runtime. */
+    float get (int index) const noexcept { return values[static_cast<size_t> (index)]; }
+
+    bool isOn (ParamIndex::Index i) const noexcept      { return (*this)[i] >= 0.5f; }
+    int  getChoice (ParamIndex::Index i) const noexcept { return static_cast<int> ((*this)[i]); }
+
+    alignas (64) std::array<float, ParamIndex::NUM_PARAMS> values {};
+};
+
+//==============================================================================
+/** The host transport at the start of one block; defaults when the host has no play head. */
+struct TransportInfo
+{
+    double      bpm           { 120.0 };
+    double      ppqPosition   { 0.0 };
+    juce::int64 timeInSamples { 0 };
+    bool        isPlaying     { false };
+};
+
+//==============================================================================
+/**
+ * ParameterSnapshot
+ *
+ * Gathers the APVTS's raw values into one ParameterValues at the start of
+ * each block. The processor captures once, before anything renders; the
+ * graph's nodes (on any render thread, ordered after the capture by
+ * GraphWorkerPool) read the same values for the whole block, so a
+ * parameter can no longer change half-way through a graph pass. The
+ * host's transport is captured with them.
+ *
+ * Message-thread code keeps reading the APVTS: the snapshot belongs to
+ * the audio thread.
+ */
+class ParameterSnapshot
+{
+public:
+    explicit ParameterSnapshot (juce::AudioProcessorValueTreeState& apvts)
+        : processor (apvts.processor)
+    {
+        for (int i = 0; i < ParamIndex::NUM_PARAMS; ++i)
+        {
+            sources[static_cast<size_t> (i)] = apvts.getRawParameterValue (ParamIndex::table[i].id);
+            jassert (sources[static_cast<size_t> (i)] != nullptr);
+
+            // The dense index doubles as the APVTS index (and modulation lane)
+            jassert (apvts.getParameter (ParamIndex::table[i].id)->getParameterIndex() == i);
+        }
+        capture();
+    }
+
+    /** Audio thread, once per block before the graph renders. */
+    const ParameterValues& capture() noexcept
+    {
+        for (size_t i = 0; i < sources.size(); ++i)
+            current.values[i] = sources[i]->load (std::memory_order_relaxed);
+
+        captureTransport();
+        return current;
+    }
+
+    const ParameterValues& getValues() const noexcept    { return current; }
+    const TransportInfo&   getTransport() const noexcept { return transport; }
+
+private:
+    void captureTransport() noexcept
+    {
+        // Only valid inside processBlock; elsewhere the last block's state stands
+        auto* playHead = processor.getPlayHead();
+        if (playHead == nullptr)
+            return;
+
+        if (const auto position = playHead->getPosition())
+        {
+            transport.bpm           = position->getBpm().orFallback (transport.bpm);
+            transport.ppqPosition   = position->getPpqPosition().orFallback (0.0);
+            transport.timeInSamples = position->getTimeInSamples().orFallback (0);
+            transport.isPlaying     = position->getIsPlaying();
+        }
+    }
+
+    juce::AudioProcessor& processor;
+    std::array<std::atomic<float>*, ParamIndex::NUM_PARAMS> sources {};
+    ParameterValues current;
+    TransportInfo   transport;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ParameterSnapshot)
+};
@@ -0,0 +1,150 @@
+#pragma once
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+ * ParameterWriteQueue
+ *
+ * Lets the audio thread change host parameters without touching the host.
+ * setValueNotifyingHost() does string work and runs every listener
+ * synchronously (the editor's among them), so realtime code instead
+ * pushes (parameter index, normalised value) events into a lock-free
+ * single-producer FIFO. A timer on the message thread drains it, keeps
+ * only the last value per parameter, and forwards each one to the host
+ * and listeners once.
+ *
+ * Parameters are addressed by ParamIndex, which is also their APVTS
+ * index, so writers need no lookups. Exactly one thread may write at a
+ * time: the processor's block-level engines share the processor's queue,
+ * and a graph node that writes (which may run on a GraphWorkerPool
+ * thread) owns its own.
+ */
+class ParameterWriteQueue : private juce::Timer
+{
+public:
+    static constexpr int DEFAULT_CAPACITY = 1024;
+    static constexpr int DRAIN_RATE_HZ    = 60;
+
+    explicit ParameterWriteQueue (juce::AudioProcessorValueTreeState& apvts,
+                                  int capacity = DEFAULT_CAPACITY)
+        : fifo (capacity), events (static_cast<size_t> (capacity))
+    {
+        for (auto* p : apvts.processor.getParameters())
+            params.push_back (p);
+
+        const auto numParams = params.size();
+        shadow   = std::make_unique<std::atomic<float>[]>  (numParams);
+        inFlight = std::make_unique<std::atomic<int>[]>    (numParams);
+        for (size_t i = 0; i < numParams; ++i)
+        {
+            shadow[i].store (0.0f);
+            inFlight[i].store (0);
+        }
+        latest.resize (numParams, 0.0f);
+        pendingCount.resize (numParams, 0);
+        touched.reserve (numParams);
+
+        startTimerHz (DRAIN_RATE_HZ);
+    }
+
+    ~ParameterWriteQueue() override { stopTimer(); }
+
+    //==============================================================================
+    /**
+     * Audio thread: queue a normalised value for the host. Returns false,
+     * dropping the write, only if the message thread has stalled long
+     * enough to fill the FIFO.
+     */
+    bool write (int index, float normalisedValue) noexcept
+    {
+        if (! isValidIndex (index))
+            return false;
+
+        if (fifo.getFreeSpace() == 0)
+            return false;
+
+        const auto i = static_cast<size_t> (index);
+        shadow[i].store (normalisedValue, std::memory_order_relaxed);
+        inFlight[i].fetch_add (1, std::memory_order_relaxed);
+
+        const auto scope = fifo.write (1);
+        scope.forEach ([&] (int slot) { events[static_cast<size_t> (slot)] = { index, normalisedValue }; });
+        return true;
+    }
+
+    /**
+     * Audio thread: the parameter's normalised value as this writer sees it
+     * — its own latest write while that is still queued, otherwise the
+     * parameter's current value. Read-modify-write engines (toggles,
+     * additive modulation) build on this so consecutive blocks don't
+     * act on a value the host hasn't received yet.
+     */
+    float getValue (int index) const noexcept
+    {
+        if (! isValidIndex (index))
+            return 0.0f;
+
+        const auto i = static_cast<size_t> (index);
+        if (inFlight[i].load (std::memory_order_acquire) > 0)
+            return shadow[i].load (std::memory_order_relaxed);
+        return params[i]->getValue();
+    }
+
+    //==============================================================================
+    /** Message thread: forward everything queued so far. Also runs on the timer. */
+    void flush()
+    {
+        const int numReady = fifo.getNumReady();
+        if (numReady == 0)
+            return;
+
+        // Coalesce: the last write per parameter wins
+        const auto scope = fifo.read (numReady);
+        scope.forEach ([&] (int slot)
+        {
+            const auto& e = events[static_cast<size_t> (slot)];
+            const auto i  = static_cast<size_t> (e.index);
+            if (pendingCount[i]++ == 0)
+                touched.push_back (e.index);
+            latest[i] = e.value;
+        });
+
+        for (int index : touched)
+        {
+            const auto i = static_cast<size_t> (index);
+            params[i]->setValueNotifyingHost (juce::jlimit (0.0f, 1.0f, latest[i]));
+            inFlight[i].fetch_sub (pendingCount[i], std::memory_order_release);
+            pendingCount[i] = 0;
+        }
+        touched.clear();
+    }
+
+private:
+    struct Event
+    {
+        int   index { -1 };
+        float value { 0.0f };
+    };
+
+    bool isValidIndex (int index) const noexcept
+    {
+        return index >= 0 && index < static_cast<int> (params.size());
+    }
+
+    void timerCallback() override { flush(); }
+
+    std::vector<juce::AudioProcessorParameter*> params;
+
+    // Audio thread → message thread
+    juce::AbstractFifo                    fifo;
+    std::vector<Event>                    events;
+    std::unique_ptr<std::atomic<float>[]> shadow;   // last queued value per parameter
+    std::unique_ptr<std::atomic<int>[]>   inFlight; // queued but not yet forwarded
+
+    // Message-thread scratch for coalescing
+    std::vector<float> latest;
+    std::vector<int>   pendingCount;
+    std::vector<int>   touched;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ParameterWriteQueue)
+};
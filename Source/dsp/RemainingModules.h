@@ -1,5 +1,6 @@
 #pragma once
 #include "MacroEngine.h"
+#include "ParameterWriteQueue.h"
 
 // Forward declaration — full definition is in ModuleGraph.h which includes us
 class ModuleGraph;
@@ -11,86 +12,121 @@ class ModuleGraph;
 #include "../AudioNode.h"
 #include "../../PluginProcessor.h"
 
-class PitchSmearDelay : public AudioNode
+class PitchSmearDelay final : public AudioNode
 {
 public:
     static constexpr int MAX_DELAY_SAMPLES = 192000; // 4s at 48kHz
 
-    explicit PitchSmearDelay (juce::AudioProcessorValueTreeState& apvts) : apvts (apvts)
-    {
-        pTime     = apvts.getRawParameterValue (ParamID::PSD_TIME);
-        pFeedback = apvts.getRawParameterValue (ParamID::PSD_FEEDBACK);
-        pSmear    = apvts.getRawParameterValue (ParamID::PSD_SMEAR);
-        pMix      = apvts.getRawParameterValue (ParamID::PSD_MIX);
-        pEnabled  = apvts.getRawParameterValue (ParamID::PSD_ENABLED);
-    }
+    explicit PitchSmearDelay (juce::AudioProcessorValueTreeState& apvts) : apvts (apvts) {}
 
     juce::String getName() const override { return "Pitch Smear Delay"; }
     juce::String getType() const override { return "pitch_smear_delay"; }
 
+    /** Delay time × the number of feedback repeats needed to fall below -100 dB. */
+    double getTailLengthSeconds (const ParameterValues* values, const ModulationBuses* buses) const override
+    {
+        const double fb = juce::jlimit (0.0, 0.999, static_cast<double> (pFeedback.getMaxValue (values, buses)));
+        const double time = pTime.getMaxValue (values, buses);
+
+        // The audio thread asks every block; the repeat count only moves with the feedback
+        if (values == nullptr)
+            return time * (1.0 + countRepeats (fb)) * 1.02; // + smear
+
+        if (fb != tailFeedback)
+        {
+            tailFeedback = fb;
+            tailRepeats  = countRepeats (fb);
+        }
+        return time * (1.0 + tailRepeats) * 1.02;
+    }
+
     void prepare (const juce::dsp::ProcessSpec& spec) override
     {
         sampleRate = spec.sampleRate;
-        numCh = static_cast<int>(spec.numChannels);
         for (int ch = 0; ch < 2; ++ch)
         {
             delayBuf[ch].assign (MAX_DELAY_SAMPLES, 0.0f);
             writePos[ch] = 0;
             smearPhase[ch] = 0.0f;
         }
+        smoother.prepare (spec.sampleRate, static_cast<int>(spec.maximumBlockSize));
+        mixer.prepare (static_cast<int>(spec.maximumBlockSize));
     }
 
     void reset() override
     {
         for (int ch = 0; ch < 2; ++ch) std::fill(delayBuf[ch].begin(), delayBuf[ch].end(), 0.0f);
+        smoother.reset();
+        mixer.reset();
     }
 
-    void process (juce::dsp::AudioBlock<float>& block) override
+    void render (const NodeContext& context) noexcept override
     {
-        if (!isEnabled() || pEnabled->load() < 0.5f) return;
-
-        const float delaySec  = pTime->load();
-        const float feedback  = pFeedback->load();
-        const float smear     = pSmear->load() * 0.02f; // max ±2% modulation
-        const float mix       = pMix->load();
+        if (! isActive (context, ParamIndex::PSD_ENABLED)) return;
+
+        const int   numSamples = context.numSamples;
+        smoother.process (context.parameters, context.modulation, numSamples);
+        const float  delaySec = pTime.getValue (context.parameters, context.modulation);
+        const float* feedback = smoother.get (feedbackSlot);
+        const float* smear    = smoother.get (smearSlot); // × 0.02: max ±2% modulation
+        mixer.update (smoother, mixSlot, numSamples);
         const int   delayLen  = juce::jlimit(1, MAX_DELAY_SAMPLES-1,
                                  static_cast<int>(delaySec * sampleRate));
 
-        for (int ch = 0; ch < numCh && ch < 2; ++ch)
+        for (int ch = 0; ch < context.numChannels && ch < 2; ++ch)
         {
-            for (int s = 0; s < (int)block.getNumSamples(); ++s)
+            float* SNOT_RESTRICT x    = context.channel (ch);
+            float* SNOT_RESTRICT line = delayBuf[ch].data();
+
+            for (int s = 0; s < numSamples; ++s)
             {
                 // Smear: LFO-modulated read pointer creates pitch wobble
                 smearPhase[ch] += 0.0003f;
                 if (smearPhase[ch] > 1.0f) smearPhase[ch] -= 1.0f;
                 const float mod = std::sin(smearPhase[ch] * juce::MathConstants<float>::twoPi);
-                const float modOffset = mod * smear * delayLen;
+                const float modOffset = mod * smear[s] * 0.02f * delayLen;
 
                 const float readPosF = writePos[ch] - delayLen + modOffset + MAX_DELAY_SAMPLES;
                 const int   readI    = static_cast<int>(readPosF) % MAX_DELAY_SAMPLES;
                 const float frac     = readPosF - std::floor(readPosF);
-                const float s0 = delayBuf[ch][readI];
-                const float s1 = delayBuf[ch][(readI+1) % MAX_DELAY_SAMPLES];
+                const float s0 = line[readI];
+                const float s1 = line[(readI+1) % MAX_DELAY_SAMPLES];
                 const float delayed = s0 + frac * (s1 - s0);
 
-                const float input = block.getSample(ch, s);
-                delayBuf[ch][writePos[ch]] = softClip(input + delayed * feedback);
+                const float input = x[s];
+                line[writePos[ch]] = softClip(input + delayed * feedback[s]);
                 writePos[ch] = (writePos[ch] + 1) % MAX_DELAY_SAMPLES;
 
-                block.setSample(ch, s, eqpCrossfade(input, delayed, mix));
+                x[s] = mixer.mixSample(input, delayed, s);
             }
         }
     }
 
 private:
     juce::AudioProcessorValueTreeState& apvts;
+    ModulatedParameter pTime     { apvts, ParamIndex::PSD_TIME };
+    ModulatedParameter pFeedback { apvts, ParamIndex::PSD_FEEDBACK };
+    ModulatedParameter pSmear    { apvts, ParamIndex::PSD_SMEAR };
+    ModulatedParameter pMix      { apvts, ParamIndex::PSD_MIX };
+    ParameterSmoother  smoother;
+    const int feedbackSlot { smoother.add (pFeedback) };
+    const int smearSlot    { smoother.add (pSmear) };
+    const int mixSlot      { smoother.add (pMix) };
+    EqualPowerMix      mixer;
     std::array<std::vector<float>, 2> delayBuf;
     std::array<int,   2> writePos   {};
     std::array<float, 2> smearPhase {};
     double sampleRate { 44100.0 };
-    int    numCh { 2 };
 
-    std::atomic<float>* pTime, *pFeedback, *pSmear, *pMix, *pEnabled;
+    // Audio-thread cache for getTailLengthSeconds()
+    mutable double tailFeedback { -1.0 };
+    mutable double tailRepeats  { 0.0 };
+
+    static double countRepeats (double fb) noexcept
+    {
+        return fb > 0.001 ? std::ceil (std::log (1.0e-5) / std::log (fb)) : 0.0;
+    }
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PitchSmearDelay)
 };
 
@@ -98,64 +134,93 @@ private:
 // StereoNeuralMotion.h
 // Mid/Side width + smooth automated panning motion (sine lfo per channel)
 // ─────────────────────────────────────────────────────────────────────────────
-class StereoNeuralMotion : public AudioNode
+class StereoNeuralMotion final : public AudioNode
 {
 public:
-    explicit StereoNeuralMotion (juce::AudioProcessorValueTreeState& apvts) : apvts(apvts)
-    {
-        pWidth   = apvts.getRawParameterValue(ParamID::SNM_WIDTH);
-        pMotion  = apvts.getRawParameterValue(ParamID::SNM_MOTION);
-        pRate    = apvts.getRawParameterValue(ParamID::SNM_RATE);
-        pEnabled = apvts.getRawParameterValue(ParamID::SNM_ENABLED);
-    }
+    explicit StereoNeuralMotion (juce::AudioProcessorValueTreeState& apvts) : apvts(apvts) {}
 
     juce::String getName() const override { return "Stereo Neural Motion"; }
     juce::String getType() const override { return "stereo_neural_motion"; }
 
+    double getTailLengthSeconds (const ParameterValues*, const ModulationBuses*) const override { return 0.0; } // memoryless
+
     void prepare (const juce::dsp::ProcessSpec& spec) override
     {
         sampleRate = spec.sampleRate;
         phase = 0.0f;
+        smoother.prepare (spec.sampleRate, static_cast<int>(spec.maximumBlockSize));
     }
 
-    void reset() override { phase = 0.0f; }
+    void reset() override { phase = 0.0f; smoother.reset(); }
 
-    void process (juce::dsp::AudioBlock<float>& block) override
+    void render (const NodeContext& context) noexcept override
     {
-        if (!isEnabled() || pEnabled->load() < 0.5f) return;
+        if (!isActive(context, ParamIndex::SNM_ENABLED)) return;
 
-        const float width  = pWidth->load();   // 0..2 (1 = unity)
-        const float motion = pMotion->load();
-        const float rate   = pRate->load();
-        const float dt     = static_cast<float>(1.0 / sampleRate);
+        const int   numSamples = context.numSamples;
+        smoother.process(context.parameters, context.modulation, numSamples);
+        const float* width  = smoother.get(widthSlot);   // 0..2 (1 = unity)
+        const float* motion = smoother.get(motionSlot);
+        const float rate   = context.getParameter(ParamIndex::SNM_RATE);
+        const float dt     = rate * static_cast<float>(1.0 / sampleRate);
 
-        for (int s = 0; s < (int)block.getNumSamples(); ++s)
+        // Mono: side is zero, so only the mid's pan motion remains
+        if (!context.isStereo())
         {
-            phase += rate * dt;
-            if (phase > 1.0f) phase -= 1.0f;
-            const float lfo = std::sin(phase * juce::MathConstants<float>::twoPi);
-
-            const float L = block.getSample(0, s);
-            const float R = block.getNumChannels() > 1 ? block.getSample(1, s) : L;
+            float* SNOT_RESTRICT x = context.channel(0);
+            for (int s = 0; s < numSamples; ++s)
+                x[s] *= nextPanGain(dt, motion[s]);
+            return;
+        }
 
-            // MS processing
-            const float mid  = (L + R) * 0.5f;
-            const float side = (L - R) * 0.5f * width;
+        // Stereo, two frames at a time: out = mid · (g, 1/g) + (x − swapped x) / 2 · width
+        using namespace StereoLanes;
+        float* SNOT_RESTRICT L = context.channel(0);
+        float* SNOT_RESTRICT R = context.channel(1);
 
-            // Motion: add lfo-driven pan oscillation to mid
-            const float panGain = 1.0f + lfo * motion * 0.3f;
+        int s = 0;
+        for (; s + 1 < numSamples; s += 2)
+        {
+            const float g0 = nextPanGain(dt, motion[s]);
+            const float g1 = nextPanGain(dt, motion[s + 1]);
+
+            const float4 x       = float4::load(L, R, s);
+            const float4 swapped = x.swapChannels();
+            const float4 gains   {{ g0, 1.0f / g0, g1, 1.0f / g1 }};
+            const float4 out = (x + swapped) * 0.5f * gains
+                             + (x - swapped) * 0.5f * float4::perFrame(width[s], width[s + 1]);
+            out.store(L, R, s);
+        }
 
-            block.setSample(0, s, mid * panGain + side);
-            if (block.getNumChannels() > 1)
-                block.setSample(1, s, mid / panGain - side);
+        if (s < numSamples)
+        {
+            const float  g     = nextPanGain(dt, motion[s]);
+            const float2 x     = float2::load(L, R, s);
+            const float  side  = x.side() * width[s];
+            const float2 out { x.mid() * g + side, x.mid() / g - side };
+            out.store(L, R, s);
         }
     }
 
 private:
     juce::AudioProcessorValueTreeState& apvts;
+    ModulatedParameter pWidth  { apvts, ParamIndex::SNM_WIDTH };
+    ModulatedParameter pMotion { apvts, ParamIndex::SNM_MOTION };
+    ParameterSmoother  smoother;
+    const int widthSlot  { smoother.add(pWidth) };
+    const int motionSlot { smoother.add(pMotion) };
     float phase { 0.0f };
+
+    /** Advance the motion LFO one sample; the mid's gain on the left (its inverse on the right). */
+    float nextPanGain(float phaseStep, float motion) noexcept
+    {
+        phase += phaseStep;
+        if (phase > 1.0f) phase -= 1.0f;
+        const float lfo = std::sin(phase * juce::MathConstants<float>::twoPi);
+        return 1.0f + lfo * motion * 0.3f;
+    }
+
     double sampleRate { 44100.0 };
-    std::atomic<float>* pWidth, *pMotion, *pRate, *pEnabled;
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StereoNeuralMotion)
 };
 
@@ -163,45 +228,43 @@ private:
 // TextureGenerator.h
 // Bandlimited noise generator blended with signal for "cosmic static" texture
 // ─────────────────────────────────────────────────────────────────────────────
-class TextureGenerator : public AudioNode
+class TextureGenerator final : public AudioNode
 {
 public:
-    explicit TextureGenerator (juce::AudioProcessorValueTreeState& apvts) : apvts(apvts)
-    {
-        pDensity   = apvts.getRawParameterValue(ParamID::TG_DENSITY);
-        pCharacter = apvts.getRawParameterValue(ParamID::TG_CHARACTER);
-        pMix       = apvts.getRawParameterValue(ParamID::TG_MIX);
-        pEnabled   = apvts.getRawParameterValue(ParamID::TG_ENABLED);
-    }
+    explicit TextureGenerator (juce::AudioProcessorValueTreeState& apvts) : apvts(apvts) {}
 
     juce::String getName() const override { return "Texture Generator"; }
     juce::String getType() const override { return "texture_generator"; }
 
+    bool canSleep (const ParameterValues*) const override { return false; } // makes noise from silence
+
     void prepare (const juce::dsp::ProcessSpec& spec) override
     {
         textureFilter.prepare(spec);
         textureFilter.setType(juce::dsp::StateVariableTPTFilterType::bandpass);
         textureFilter.setCutoffFrequency(800.0f);
         textureFilter.setResonance(2.0f);
+        smoother.prepare(spec.sampleRate, static_cast<int>(spec.maximumBlockSize));
     }
 
-    void reset() override { textureFilter.reset(); }
+    void reset() override { textureFilter.reset(); smoother.reset(); }
 
-    void process (juce::dsp::AudioBlock<float>& block) override
+    void render (const NodeContext& context) noexcept override
     {
-        if (!isEnabled() || pEnabled->load() < 0.5f) return;
+        if (!isActive(context, ParamIndex::TG_ENABLED)) return;
 
-        const float density   = pDensity->load();
-        const float character = pCharacter->load();
-        const float mix       = pMix->load() * 0.3f; // max 30% texture
+        const float density   = pDensity.getValue(context.parameters, context.modulation);
+        const float character = pCharacter.getValue(context.parameters, context.modulation);
+        smoother.process(context.parameters, context.modulation, context.numSamples);
+        const float* mix      = smoother.get(mixSlot); // × 0.3: max 30% texture
 
         // Update filter based on character (brightness of texture)
         const float cutoff = juce::jmap(character, 200.0f, 8000.0f);
         textureFilter.setCutoffFrequency(cutoff);
 
-        for (int s = 0; s < (int)block.getNumSamples(); ++s)
+        for (int s = 0; s < context.numSamples; ++s)
         {
-            for (int ch = 0; ch < (int)block.getNumChannels(); ++ch)
+            for (int ch = 0; ch < context.numChannels; ++ch)
             {
                 // Sparse noise (density controls hit probability)
                 float noise = 0.0f;
@@ -209,8 +272,7 @@ public:
                     noise = (random.nextFloat() * 2.0f - 1.0f);
 
                 const float filtered = textureFilter.processSample(ch, noise);
-                const float sig = block.getSample(ch, s);
-                block.setSample(ch, s, sig + filtered * mix);
+                context.channel(ch)[s] += filtered * mix[s] * 0.3f;
             }
         }
     }
@@ -219,7 +281,11 @@ private:
     juce::AudioProcessorValueTreeState& apvts;
     juce::dsp::StateVariableTPTFilter<float> textureFilter;
     juce::Random random;
-    std::atomic<float>* pDensity, *pCharacter, *pMix, *pEnabled;
+    ModulatedParameter pDensity   { apvts, ParamIndex::TG_DENSITY };
+    ModulatedParameter pCharacter { apvts, ParamIndex::TG_CHARACTER };
+    ModulatedParameter pMix       { apvts, ParamIndex::TG_MIX };
+    ParameterSmoother  smoother;
+    const int mixSlot { smoother.add(pMix) };
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TextureGenerator)
 };
 
@@ -227,23 +293,27 @@ private:
 // FreezeCapture.h
 // Circular buffer capture + looping playback with pitch shift
 // ─────────────────────────────────────────────────────────────────────────────
-class FreezeCapture : public AudioNode
+class FreezeCapture final : public AudioNode
 {
 public:
     static constexpr int CAPTURE_SIZE = 192000; // 4s at 48kHz
 
-    explicit FreezeCapture (juce::AudioProcessorValueTreeState& apvts) : apvts(apvts)
-    {
-        pFreeze  = apvts.getRawParameterValue(ParamID::FC_FREEZE);
-        pSize    = apvts.getRawParameterValue(ParamID::FC_SIZE);
-        pPitch   = apvts.getRawParameterValue(ParamID::FC_PITCH);
-        pMix     = apvts.getRawParameterValue(ParamID::FC_MIX);
-        pEnabled = apvts.getRawParameterValue(ParamID::FC_ENABLED);
-    }
+    explicit FreezeCapture (juce::AudioProcessorValueTreeState& apvts) : apvts(apvts) {}
 
     juce::String getName() const override { return "Freeze Capture"; }
     juce::String getType() const override { return "freeze_capture"; }
 
+    /** Frozen playback sounds without input; capturing must fill the buffer with silence first. */
+    bool canSleep (const ParameterValues* values) const override
+    {
+        return pFreeze.getBaseValue(values) < 0.5f;
+    }
+
+    double getTailLengthSeconds (const ParameterValues* values, const ModulationBuses*) const override
+    {
+        return pSize.getBaseValue(values);
+    }
+
     void prepare (const juce::dsp::ProcessSpec& spec) override
     {
         sampleRate = spec.sampleRate;
@@ -251,49 +321,70 @@ public:
             captureBuf[ch].assign(CAPTURE_SIZE, 0.0f);
         writePos = 0;
         readPos  = 0.0;
+        smoother.prepare(spec.sampleRate, static_cast<int>(spec.maximumBlockSize));
+        mixer.prepare(static_cast<int>(spec.maximumBlockSize));
     }
 
-    void reset() override { writePos = 0; readPos = 0.0; }
+    void reset() override { writePos = 0; readPos = 0.0; smoother.reset(); mixer.reset(); }
 
-    void process (juce::dsp::AudioBlock<float>& block) override
+    void render (const NodeContext& context) noexcept override
     {
-        if (!isEnabled() || pEnabled->load() < 0.5f) return;
-
-        const bool frozen  = pFreeze->load() > 0.5f;
-        const float sizeSec = pSize->load();
-        const float pitch   = pPitch->load(); // semitones
-        const float mix     = pMix->load();
+        if (!isActive(context, ParamIndex::FC_ENABLED)) return;
+
+        const bool frozen  = context.getParameter(ParamIndex::FC_FREEZE) > 0.5f;
+        const float sizeSec = context.getParameter(ParamIndex::FC_SIZE);
+        const float pitch   = pPitch.getValue(context.parameters, context.modulation); // semitones
+        const int numSamples = context.numSamples;
+        smoother.process(context.parameters, context.modulation, numSamples);
+        mixer.update(smoother, mixSlot, numSamples);
         const int   captureLen = juce::jlimit(1, CAPTURE_SIZE-1,
                                   static_cast<int>(sizeSec * sampleRate));
 
         // Pitch ratio from semitones
         const float ratio = std::pow(2.0f, pitch / 12.0f);
 
-        for (int s = 0; s < (int)block.getNumSamples(); ++s)
+        // A mono block captures into, and plays from, the left buffer only
+        using namespace StereoLanes;
+        const bool stereo = context.isStereo();
+        float* SNOT_RESTRICT L = context.channel(0);
+        float* SNOT_RESTRICT R = stereo ? context.channel(1) : nullptr;
+        float* SNOT_RESTRICT capL = captureBuf[0].data();
+        float* SNOT_RESTRICT capR = captureBuf[1].data();
+
+        if (!frozen)
         {
-            if (!frozen)
+            // Capture mode: write input to buffer
+            for (int s = 0; s < numSamples; ++s)
             {
-                // Capture mode: write input to buffer
-                for (int ch = 0; ch < 2 && ch < (int)block.getNumChannels(); ++ch)
-                    captureBuf[ch][writePos % CAPTURE_SIZE] = block.getSample(ch, s);
+                capL[writePos] = L[s];
+                if (stereo) capR[writePos] = R[s];
                 writePos = (writePos + 1) % CAPTURE_SIZE;
             }
+            return;
+        }
+
+        // Playback mode: read from captured buffer with pitch, both channels per frame
+        for (int s = 0; s < numSamples; ++s)
+        {
+            readPos += ratio;
+            if (readPos >= captureLen) readPos -= captureLen;
+            const int   ri   = static_cast<int>(readPos);
+            const float frac = static_cast<float>(readPos - ri);
+            const int   i0   = ri % captureLen;
+            const int   i1   = (ri + 1) % captureLen;
+
+            if (stereo)
+            {
+                const float2 frozenFrame = StereoLanes::lerp(float2::load(capL, capR, i0), float2::load(capL, capR, i1), frac);
+                const float2 dry         = float2::load(L, R, s);
+                const float2 out { mixer.mixSample(dry.l, frozenFrame.l, s),
+                                   mixer.mixSample(dry.r, frozenFrame.r, s) };
+                out.store(L, R, s);
+            }
             else
             {
-                // Playback mode: read from captured buffer with pitch
-                readPos += ratio;
-                if (readPos >= captureLen) readPos -= captureLen;
-                const int   ri   = static_cast<int>(readPos);
-                const float frac = static_cast<float>(readPos - ri);
-
-                for (int ch = 0; ch < 2 && ch < (int)block.getNumChannels(); ++ch)
-                {
-                    const float s0 = captureBuf[ch][ri % captureLen];
-                    const float s1 = captureBuf[ch][(ri + 1) % captureLen];
-                    const float frozen_sample = s0 + frac * (s1 - s0);
-                    const float dry = block.getSample(ch, s);
-                    block.setSample(ch, s, eqpCrossfade(dry, frozen_sample, mix));
-                }
+                const float frozenSample = capL[i0] + frac * (capL[i1] - capL[i0]);
+                L[s] = mixer.mixSample(L[s], frozenSample, s);
             }
         }
     }
@@ -304,28 +395,32 @@ private:
     int    writePos { 0 };
     double readPos  { 0.0 };
     double sampleRate { 44100.0 };
-    std::atomic<float>* pFreeze, *pSize, *pPitch, *pMix, *pEnabled;
+    ModulatedParameter pPitch { apvts, ParamIndex::FC_PITCH };
+    ModulatedParameter pMix   { apvts, ParamIndex::FC_MIX };
+    ModulatedParameter pFreeze { apvts, ParamIndex::FC_FREEZE }; // unmodulated: sleep and tail only
+    ModulatedParameter pSize   { apvts, ParamIndex::FC_SIZE };
+    ParameterSmoother  smoother;
+    const int mixSlot { smoother.add(pMix) };
+    EqualPowerMix      mixer;
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FreezeCapture)
 };
 
 // ─────────────────────────────────────────────────────────────────────────────
 // MutationEngine.h
-// Randomly modulates active parameters within musical bounds over time
+// Randomly modulates active parameters within musical bounds over time.
+// Writes go through a ParameterWriteQueue of its own: the node may run on
+// a graph worker thread, and each queue takes a single writer.
 // ─────────────────────────────────────────────────────────────────────────────
-class MutationEngine : public AudioNode
+class MutationEngine final : public AudioNode
 {
 public:
-    explicit MutationEngine (juce::AudioProcessorValueTreeState& apvts) : apvts(apvts)
-    {
-        pAmount    = apvts.getRawParameterValue(ParamID::ME_AMOUNT);
-        pRate      = apvts.getRawParameterValue(ParamID::ME_RATE);
-        pCharacter = apvts.getRawParameterValue(ParamID::ME_CHARACTER);
-        pEnabled   = apvts.getRawParameterValue(ParamID::ME_ENABLED);
-    }
+    explicit MutationEngine (juce::AudioProcessorValueTreeState& apvts) : apvts(apvts), writeQueue(apvts) {}
 
     juce::String getName() const override { return "Mutation Engine"; }
     juce::String getType() const override { return "mutation_engine"; }
 
+    bool canSleep (const ParameterValues*) const override { return false; } // mutates on its own clock
+
     void prepare (const juce::dsp::ProcessSpec& spec) override
     {
         sampleRate = spec.sampleRate;
@@ -335,43 +430,39 @@ public:
     void reset() override { samplesUntilMutation = 1000; }
 
     /** Mutation happens on audio thread — only modulates safe parameters. */
-    void process (juce::dsp::AudioBlock<float>& block) override
+    void render (const NodeContext& context) noexcept override
     {
-        if (!isEnabled() || pEnabled->load() < 0.5f) return;
+        if (!isActive(context, ParamIndex::ME_ENABLED)) return;
 
-        samplesUntilMutation -= static_cast<int>(block.getNumSamples());
+        samplesUntilMutation -= context.numSamples;
         if (samplesUntilMutation > 0) return;
 
-        const float rate      = pRate->load();
-        const float amount    = pAmount->load();
+        const float rate      = context.getParameter(ParamIndex::ME_RATE);
+        const float amount    = context.getParameter(ParamIndex::ME_AMOUNT);
         samplesUntilMutation  = static_cast<int>(sampleRate / rate);
 
-        // Mutate a selection of "safe" parameters
-        const std::initializer_list<const char*> mutateTargets = {
-            ParamID::PR_DRIFT, ParamID::PR_SHIMMER,
-            ParamID::SWC_DEPTH, ParamID::SWC_WARP,
-            ParamID::PSD_SMEAR, ParamID::SNM_MOTION,
-            ParamID::GF_CURVE
-        };
-
-        for (auto* paramId : mutateTargets)
+        for (int index : mutateTargets)
         {
             if (random.nextFloat() > 0.4f) continue; // not every param each time
-            if (auto* param = apvts.getParameter(paramId))
-            {
-                const float current = param->getValue();
-                const float delta   = (random.nextFloat() * 2.0f - 1.0f) * amount * 0.15f;
-                param->setValueNotifyingHost(juce::jlimit(0.0f, 1.0f, current + delta));
-            }
+            const float current = writeQueue.getValue(index);
+            const float delta   = (random.nextFloat() * 2.0f - 1.0f) * amount * 0.15f;
+            writeQueue.write(index, juce::jlimit(0.0f, 1.0f, current + delta));
         }
     }
 
 private:
     juce::AudioProcessorValueTreeState& apvts;
+    // Mutate a selection of "safe" parameters
+    static constexpr ParamIndex::Index mutateTargets[] = {
+        ParamIndex::PR_DRIFT, ParamIndex::PR_SHIMMER,
+        ParamIndex::SWC_DEPTH, ParamIndex::SWC_WARP,
+        ParamIndex::PSD_SMEAR, ParamIndex::SNM_MOTION,
+        ParamIndex::GF_CURVE
+    };
+    ParameterWriteQueue writeQueue;
     double sampleRate { 44100.0 };
     int    samplesUntilMutation { 22050 };
     juce::Random random;
-    std::atomic<float>* pAmount, *pRate, *pCharacter, *pEnabled;
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MutationEngine)
 };
 
@@ -383,7 +474,11 @@ private:
 class OversamplingChain
 {
 public:
-    OversamplingChain() { buildChain(2); }
+    explicit OversamplingChain (int factor = 2, int numChannels = 2)
+        : numChannels (numChannels), currentFactor (factor)
+    {
+        buildChain (orderFor (factor));
+    }
 
     void prepare (const juce::dsp::ProcessSpec& spec)
     {
@@ -405,25 +500,28 @@ public:
     {
         if (factor == currentFactor) return;
         currentFactor = factor;
-        const int order = factor == 1 ? 0 : factor == 2 ? 1 : factor == 4 ? 2 : 3;
-        buildChain(order);
+        buildChain(orderFor(factor));
         if (baseSpec.sampleRate > 0)
             chain->initProcessing(baseSpec.maximumBlockSize);
     }
 
+    int getFactor() const noexcept { return currentFactor; }
     float getLatencyInSamples() const { return chain->getLatencyInSamples(); }
     void  reset() { chain->reset(); }
 
 private:
+    static int orderFor (int factor) { return factor <= 1 ? 0 : factor == 2 ? 1 : factor == 4 ? 2 : 3; }
+
     void buildChain (int order)
     {
         chain = std::make_unique<juce::dsp::Oversampling<float>>(
-            2, order,
+            static_cast<size_t>(numChannels), order,
             juce::dsp::Oversampling<float>::filterHalfBandFIREquiripple, true);
     }
 
     std::unique_ptr<juce::dsp::Oversampling<float>> chain;
     juce::dsp::ProcessSpec baseSpec {};
+    int numChannels   { 2 };
     int currentFactor { 2 };
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OversamplingChain)
@@ -490,7 +588,8 @@ private:
 class MidiRouter
 {
 public:
-    explicit MidiRouter (juce::AudioProcessorValueTreeState& apvts) : apvts(apvts) {}
+    MidiRouter (juce::AudioProcessorValueTreeState& apvts, ParameterWriteQueue& writeQueue)
+        : apvts(apvts), writeQueue(writeQueue) {}
 
     void process (juce::MidiBuffer& midi, MacroEngine& macros)
     {
@@ -507,21 +606,18 @@ public:
                 {
                     const int macroIdx = cc - 1;
                     const float norm   = val / 127.0f;
-                    if (auto* p = apvts.getParameter("macro_" + juce::String(macroIdx + 1)))
-                        p->setValueNotifyingHost(norm);
+                    writeQueue.write(ParamIndex::MACRO_1 + macroIdx, norm);
                 }
             }
 
             // Note C1 (36) → Freeze toggle
             if (msg.isNoteOn() && msg.getNoteNumber() == 36)
-            {
-                if (auto* p = apvts.getParameter(ParamID::FC_FREEZE))
-                    p->setValueNotifyingHost(p->getValue() > 0.5f ? 0.0f : 1.0f);
-            }
+                writeQueue.write(ParamIndex::FC_FREEZE, writeQueue.getValue(ParamIndex::FC_FREEZE) > 0.5f ? 0.0f : 1.0f);
         }
     }
 
 private:
     juce::AudioProcessorValueTreeState& apvts;
+    ParameterWriteQueue& writeQueue;
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MidiRouter)
 };
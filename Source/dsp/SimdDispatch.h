@@ -0,0 +1,32 @@
+#pragma once
+#include <JuceHeader.h>
+#if JUCE_INTEL
+ #include <immintrin.h>
+#endif
+
+//==============================================================================
+/**
+ * Runtime ISA dispatch helpers.
+ *
+ * Kernels for wider instruction sets than the build baseline are written
+ * as separate functions tagged with SNOT_TARGET_ISA and chosen once at
+ * runtime through juce::SystemStats, so the plugin still loads on older
+ * CPUs. MSVC needs no tag: it emits any intrinsic without extra flags.
+ */
+#if JUCE_INTEL && (JUCE_GCC || JUCE_CLANG)
+ #define SNOT_TARGET_ISA(isa) __attribute__ ((target (isa)))
+#else
+ #define SNOT_TARGET_ISA(isa)
+#endif
+
+/**
+ * Marks a channel pointer as the only route to its samples inside a
+ * kernel, so loops over it can be vectorised without alias checks.
+ */
+#if JUCE_MSVC
+ #define SNOT_RESTRICT __restrict
+#elif JUCE_GCC || JUCE_CLANG
+ #define SNOT_RESTRICT __restrict__
+#else
+ #define SNOT_RESTRICT
+#endif
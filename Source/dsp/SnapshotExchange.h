@@ -0,0 +1,94 @@
+#pragma once
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+ * SnapshotExchange — hands immutable configuration from the message thread
+ * to the audio thread without locks, the way ModuleGraph hands over its
+ * GraphSnapshots.
+ *
+ * The message thread builds a complete T and publish()es it; the audio
+ * thread calls acquire() once at the start of each block and uses the
+ * returned object until the next block. A snapshot published but never
+ * adopted is freed on the next publish; older ones are freed once the
+ * audio thread has moved past them, when the message thread next
+ * publishes or calls reclaim(). The audio thread never allocates, frees
+ * or waits.
+ */
+template <typename T>
+class SnapshotExchange
+{
+public:
+    SnapshotExchange() = default;
+
+    //==============================================================================
+    /** Message thread: make snapshot the configuration from the next block on. */
+    void publish (std::unique_ptr<T> snapshot)
+    {
+        auto entry = std::make_unique<Entry>();
+        entry->snapshot   = std::move (snapshot);
+        entry->generation = ++lastPublishedGeneration;
+        auto* raw = entry.get();
+        live.push_back (std::move (entry));
+
+        // A pending snapshot the audio thread never adopted can go at once
+        if (auto* superseded = pending.exchange (raw, std::memory_order_acq_rel))
+            erase (superseded);
+
+        reclaim();
+    }
+
+    /** Message thread: free every snapshot older than the one in use. */
+    void reclaim()
+    {
+        const auto adopted = adoptedGeneration.load (std::memory_order_acquire);
+        live.erase (std::remove_if (live.begin(), live.end(),
+                                    [adopted] (const std::unique_ptr<Entry>& e) { return e->generation < adopted; }),
+                    live.end());
+    }
+
+    /** Message thread: the most recently published snapshot, or nullptr. */
+    const T* getLatest() const noexcept
+    {
+        return live.empty() ? nullptr : live.back()->snapshot.get();
+    }
+
+    //==============================================================================
+    /**
+     * Audio thread, once per block: adopt the newest snapshot if there is
+     * one. The result (nullptr before the first publish) stays valid until
+     * the next call.
+     */
+    const T* acquire() noexcept
+    {
+        if (auto* next = pending.exchange (nullptr, std::memory_order_acq_rel))
+        {
+            active = next;
+            adoptedGeneration.store (next->generation, std::memory_order_release);
+        }
+        return active != nullptr ? active->snapshot.get() : nullptr;
+    }
+
+private:
+    struct Entry
+    {
+        std::unique_ptr<T> snapshot;
+        juce::uint64       generation { 0 };
+    };
+
+    void erase (Entry* entry)
+    {
+        live.erase (std::remove_if (live.begin(), live.end(),
+                                    [entry] (const std::unique_ptr<Entry>& e) { return e.get() == entry; }),
+                    live.end());
+    }
+
+    // Message thread owns live, the audio thread owns active; the atomics are shared
+    std::vector<std::unique_ptr<Entry>> live;
+    std::atomic<Entry*>                 pending           { nullptr };
+    std::atomic<juce::uint64>           adoptedGeneration { 0 };
+    Entry*                              active            { nullptr };
+    juce::uint64                        lastPublishedGeneration { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE (SnapshotExchange)
+};
@@ -0,0 +1,77 @@
+#pragma once
+#include <JuceHeader.h>
+#include "SimdDispatch.h"
+
+//==============================================================================
+/**
+ * SpectralOps — vector kernels over interleaved complex spectra
+ * ({re0, im0, re1, im1, ...}, as produced by juce::dsp::FFT).
+ */
+struct SpectralOps
+{
+    /**
+     * spectrum[k] *= gain[k] for numBins bins. The gain's real and imaginary
+     * parts are each stored duplicated per bin ({g0, g0, g1, g1, ...}) —
+     * the layout the SIMD kernels consume without shuffling — so both
+     * arrays hold numBins × 2 floats.
+     */
+    static void multiplyByComplexGain (float* spectrum, const float* gainRe,
+                                       const float* gainIm, int numBins) noexcept
+    {
+        static const auto kernel = selectComplexGainKernel();
+        kernel (spectrum, gainRe, gainIm, numBins);
+    }
+
+private:
+    using ComplexGainKernel = void (*) (float*, const float*, const float*, int);
+
+    static ComplexGainKernel selectComplexGainKernel() noexcept
+    {
+       #if JUCE_INTEL
+        if (juce::SystemStats::hasAVX())  return &complexGainAVX;
+        if (juce::SystemStats::hasSSE3()) return &complexGainSSE3;
+       #endif
+        return &complexGainScalar;
+    }
+
+    static void complexGainScalar (float* x, const float* gr, const float* gi, int numBins) noexcept
+    {
+        for (int i = 0; i < numBins * 2; i += 2)
+        {
+            const float re = x[i], im = x[i + 1];
+            x[i]     = re * gr[i] - im * gi[i];
+            x[i + 1] = im * gr[i] + re * gi[i];
+        }
+    }
+
+   #if JUCE_INTEL
+    // (re, im)·(gr, gi) = addsub (x·gr, swap(x)·gi)
+    SNOT_TARGET_ISA ("sse3")
+    static void complexGainSSE3 (float* x, const float* gr, const float* gi, int numBins) noexcept
+    {
+        const int vecEnd = (numBins & ~1) * 2;
+        for (int i = 0; i < vecEnd; i += 4)
+        {
+            const __m128 v = _mm_loadu_ps (x + i);
+            const __m128 swapped = _mm_shuffle_ps (v, v, _MM_SHUFFLE (2, 3, 0, 1));
+            _mm_storeu_ps (x + i, _mm_addsub_ps (_mm_mul_ps (v, _mm_loadu_ps (gr + i)),
+                                                 _mm_mul_ps (swapped, _mm_loadu_ps (gi + i))));
+        }
+        complexGainScalar (x + vecEnd, gr + vecEnd, gi + vecEnd, numBins - vecEnd / 2);
+    }
+
+    SNOT_TARGET_ISA ("avx")
+    static void complexGainAVX (float* x, const float* gr, const float* gi, int numBins) noexcept
+    {
+        const int vecEnd = (numBins & ~3) * 2;
+        for (int i = 0; i < vecEnd; i += 8)
+        {
+            const __m256 v = _mm256_loadu_ps (x + i);
+            const __m256 swapped = _mm256_permute_ps (v, 0xB1);
+            _mm256_storeu_ps (x + i, _mm256_addsub_ps (_mm256_mul_ps (v, _mm256_loadu_ps (gr + i)),
+                                                       _mm256_mul_ps (swapped, _mm256_loadu_ps (gi + i))));
+        }
+        complexGainScalar (x + vecEnd, gr + vecEnd, gi + vecEnd, numBins - vecEnd / 2);
+    }
+   #endif
+};
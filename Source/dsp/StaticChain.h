@@ -0,0 +1,187 @@
+#pragma once
+#include <JuceHeader.h>
+#include "AudioNode.h"
+#include "NodeFactory.h"
+
+//==============================================================================
+/**
+ * StepRunner — the per-step work shared by ModuleGraph's dynamic render
+ * path and StaticChain: sleep tracking, bypass, profiling and the
+ * render() call itself.
+ */
+struct StepRunner
+{
+    static constexpr float SILENCE_THRESHOLD = 1.0e-5f; // -100 dBFS
+
+    /**
+     * Track the silent-input run of a step's nodes; true once it has
+     * outlasted their combined tail. A region sleeps only as a whole. The
+     * tail is the longest reported since the input was last heard, so
+     * shortening it (or modulation swinging it down) can't cut off audio
+     * that is still ringing.
+     */
+    static bool shouldSleep (AudioNode* const* stepNodes, int numNodes, int oversampling,
+                             float* const* in, int channels, int samples, double sampleRate) noexcept
+    {
+        bool sleepable = true;
+        for (int k = 0; k < numNodes; ++k)
+            sleepable = sleepable && stepNodes[k]->canSleepThisBlock();
+
+        bool silent = sleepable;
+        for (int ch = 0; silent && ch < channels; ++ch)
+            silent = juce::FloatVectorOperations::findMaximum (in[ch], samples) <= SILENCE_THRESHOLD
+                  && juce::FloatVectorOperations::findMinimum (in[ch], samples) >= -SILENCE_THRESHOLD;
+
+        double tail = 0.0;
+        for (int k = 0; k < numNodes; ++k)
+        {
+            auto& node = *stepNodes[k];
+            const double nodeTail = node.getBlockTailSeconds();
+            node.silentInputSamples = silent ? node.silentInputSamples + samples : 0;
+            node.silentRunTail      = silent ? juce::jmax (node.silentRunTail, nodeTail) : nodeTail;
+            tail += node.silentRunTail;
+        }
+        if (oversampling > 1)
+            tail += 0.01; // resampling filters
+
+        return silent && static_cast<double> (stepNodes[0]->silentInputSamples)
+                             > tail * sampleRate + samples;
+    }
+
+    /**
+     * Render one node in place over raw channels; disabled nodes pass their
+     * input straight through. With a final NodeType the call is direct and
+     * can be inlined.
+     */
+    template <typename NodeType>
+    static void run (NodeType& node, float* const* channels, int numChannels,
+                     int numSamples, int baseSamples) noexcept
+    {
+        if (! node.isEnabled())
+        {
+            node.getProfileStats().recordSkip();
+            return;
+        }
+
+        // Timed against base-rate samples so oversampled nodes compare fairly
+        ScopedNodeTimer timer (node.getProfileStats(), baseSamples);
+        node.render (node.makeContext (channels, numChannels, numSamples));
+    }
+
+    /** The same over an AudioBlock, such as an oversampler's upsampled one. */
+    template <typename NodeType>
+    static void run (NodeType& node, juce::dsp::AudioBlock<float>& block, int baseSamples) noexcept
+    {
+        float* channels[NodeContext::MAX_CHANNELS] {};
+        const int numChannels = NodeContext::gatherChannels (block, channels);
+        run (node, channels, numChannels, static_cast<int> (block.getNumSamples()), baseSamples);
+    }
+};
+
+//==============================================================================
+/** What a chain needs to render one block in place on the main buffer. */
+struct ChainContext
+{
+    float* const* channels    { nullptr };
+    int           numChannels { 0 };
+    int           numSamples  { 0 };
+    double        sampleRate  { 44100.0 };
+    const std::unique_ptr<OversamplingChain>* oversamplers { nullptr }; // one per stage
+};
+
+/** Type-erased handle so a GraphSnapshot can hold any StaticChain. */
+class RenderChain
+{
+public:
+    virtual ~RenderChain() = default;
+    virtual void render (const ChainContext& context) noexcept = 0;
+};
+
+//==============================================================================
+/**
+ * StaticChain
+ *
+ * A serial chain whose stage types are known at compile time. Each stage
+ * is called through its concrete (final) type, so the per-node virtual
+ * dispatch of the dynamic graph disappears and the compiler is free to
+ * inline the stages into one function. ModuleGraph uses it automatically
+ * whenever the compiled plan is exactly this chain, rendering in place.
+ */
+template <typename... NodeTypes>
+class StaticChain final : public RenderChain
+{
+public:
+    static_assert ((std::is_final_v<NodeTypes> && ...), "stages must be final to devirtualise");
+
+    /** A chain over `nodes` if they are exactly NodeTypes..., in order; otherwise nullptr. */
+    static std::unique_ptr<RenderChain> tryCreate (const std::vector<AudioNode*>& nodes)
+    {
+        if (nodes.size() != sizeof... (NodeTypes))
+            return nullptr;
+
+        auto chain = std::unique_ptr<StaticChain> (new StaticChain());
+        if (! chain->bind (nodes, std::index_sequence_for<NodeTypes...>{}))
+            return nullptr;
+        return chain;
+    }
+
+    void render (const ChainContext& context) noexcept override
+    {
+        renderStages (context, std::index_sequence_for<NodeTypes...>{});
+    }
+
+private:
+    StaticChain() = default;
+
+    template <size_t... I>
+    bool bind (const std::vector<AudioNode*>& nodes, std::index_sequence<I...>)
+    {
+        return (((std::get<I> (stages) = dynamic_cast<NodeTypes*> (nodes[I])) != nullptr) && ...);
+    }
+
+    template <size_t... I>
+    void renderStages (const ChainContext& context, std::index_sequence<I...>) noexcept
+    {
+        (renderStage<I> (context), ...);
+    }
+
+    template <size_t I>
+    void renderStage (const ChainContext& context) noexcept
+    {
+        auto& node = *std::get<I> (stages);
+        AudioNode* const asBase[] { &node };
+
+        const auto& os = context.oversamplers[I];
+        if (StepRunner::shouldSleep (asBase, 1, os != nullptr ? os->getFactor() : 1,
+                                     context.channels, context.numChannels,
+                                     context.numSamples, context.sampleRate))
+        {
+            node.getProfileStats().recordSkip();
+            return;
+        }
+
+        if (os != nullptr)
+        {
+            juce::dsp::AudioBlock<float> block (context.channels,
+                                                static_cast<size_t> (context.numChannels),
+                                                static_cast<size_t> (context.numSamples));
+            auto upsampled = os->processSamplesUp (block);
+            StepRunner::run (node, upsampled, context.numSamples);
+            os->processSamplesDown (block);
+        }
+        else
+        {
+            StepRunner::run (node, context.channels, context.numChannels,
+                             context.numSamples, context.numSamples);
+        }
+    }
+
+    std::tuple<NodeTypes*...> stages {};
+};
+
+//==============================================================================
+/** The chain buildDefaultGraph() produces. */
+using DefaultChain = StaticChain<GravityCurveFilter, SpectralWarpChorus, PitchSmearDelay,
+                                 PortalReverb, PlasmaDistortion, StereoNeuralMotion,
+                                 Harmonic808Inflator, TextureGenerator, FreezeCapture,
+                                 MutationEngine>;
@@ -0,0 +1,84 @@
+#pragma once
+#include <JuceHeader.h>
+#include "SimdDispatch.h"
+
+//==============================================================================
+/**
+ * Stereo lane types for kernels that treat L and R alike.
+ *
+ * float2 holds one stereo frame. float4 holds two consecutive frames,
+ * laid out L0 R0 L1 R1. A linked kernel writes its maths once on these
+ * types. float4's element-wise operators are fixed four-lane loops, which
+ * the compiler turns into one SSE/NEON operation. Loads and stores go
+ * straight to a node's channel spans, so nothing is interleaved into a
+ * scratch buffer.
+ *
+ *     for (; s + 1 < n; s += 2)
+ *         (float4::load (l, r, s) * gains).store (l, r, s);
+ */
+namespace StereoLanes
+{
+    //==============================================================================
+    struct float2
+    {
+        float l { 0.0f };
+        float r { 0.0f };
+
+        static float2 load (const float* SNOT_RESTRICT left, const float* SNOT_RESTRICT right, int s) noexcept
+        {
+            return { left[s], right[s] };
+        }
+
+        void store (float* SNOT_RESTRICT left, float* SNOT_RESTRICT right, int s) const noexcept
+        {
+            left[s]  = l;
+            right[s] = r;
+        }
+
+        float  mid() const noexcept            { return (l + r) * 0.5f; }
+        float  side() const noexcept           { return (l - r) * 0.5f; }
+        float2 swapChannels() const noexcept   { return { r, l }; }
+
+        friend float2 operator+ (float2 a, float2 b) noexcept { return { a.l + b.l, a.r + b.r }; }
+        friend float2 operator- (float2 a, float2 b) noexcept { return { a.l - b.l, a.r - b.r }; }
+        friend float2 operator* (float2 a, float2 b) noexcept { return { a.l * b.l, a.r * b.r }; }
+        friend float2 operator* (float2 a, float g)  noexcept { return { a.l * g, a.r * g }; }
+    };
+
+    /** Linear interpolation between two frames, both channels at once. */
+    inline float2 lerp (float2 a, float2 b, float t) noexcept { return a + (b - a) * t; }
+
+    //==============================================================================
+    struct float4
+    {
+        alignas (16) float v[4] {};
+
+        /** Frames s and s + 1 of a stereo pair. */
+        static float4 load (const float* SNOT_RESTRICT left, const float* SNOT_RESTRICT right, int s) noexcept
+        {
+            return {{ left[s], right[s], left[s + 1], right[s + 1] }};
+        }
+
+        void store (float* SNOT_RESTRICT left, float* SNOT_RESTRICT right, int s) const noexcept
+        {
+            left[s]      = v[0];
+            right[s]     = v[1];
+            left[s + 1]  = v[2];
+            right[s + 1] = v[3];
+        }
+
+        /** One value per frame, repeated across its two channels. */
+        static float4 perFrame (float frame0, float frame1) noexcept
+        {
+            return {{ frame0, frame0, frame1, frame1 }};
+        }
+
+        float2 frame (int i) const noexcept { return { v[2 * i], v[2 * i + 1] }; }
+        float4 swapChannels() const noexcept { return {{ v[1], v[0], v[3], v[2] }}; }
+
+        friend float4 operator+ (const float4& a, const float4& b) noexcept { float4 o; for (int i = 0; i < 4; ++i) o.v[i] = a.v[i] + b.v[i]; return o; }
+        friend float4 operator- (const float4& a, const float4& b) noexcept { float4 o; for (int i = 0; i < 4; ++i) o.v[i] = a.v[i] - b.v[i]; return o; }
+        friend float4 operator* (const float4& a, const float4& b) noexcept { float4 o; for (int i = 0; i < 4; ++i) o.v[i] = a.v[i] * b.v[i]; return o; }
+        friend float4 operator* (const float4& a, float g)         noexcept { float4 o; for (int i = 0; i < 4; ++i) o.v[i] = a.v[i] * g;        return o; }
+    };
+}
@@ -0,0 +1,262 @@
+#pragma once
+#include <JuceHeader.h>
+#include <map>
+#include "FftBackend.h"
+
+//==============================================================================
+/**
+ * StftPlan — the immutable, shareable half of an STFT: the FFT backend and
+ * a normalised Hann window for one size. Plans are cached process-wide, so
+ * every engine of the same size, in any plugin instance, uses one copy.
+ * FftBackend transforms are const and safe to call from several threads.
+ */
+class StftPlan
+{
+public:
+    /** The shared plan for 2^fftOrder points. Message thread (prepare time). */
+    static std::shared_ptr<const StftPlan> get (int fftOrder)
+    {
+        static juce::CriticalSection lock;
+        static std::map<int, std::weak_ptr<const StftPlan>> cache;
+
+        const juce::ScopedLock sl (lock);
+        auto& slot = cache[fftOrder];
+        if (auto plan = slot.lock())
+            return plan;
+
+        std::shared_ptr<const StftPlan> plan (new StftPlan (fftOrder));
+        slot = plan;
+        return plan;
+    }
+
+    int getSize() const noexcept { return size; }
+
+    const std::unique_ptr<const FftBackend> fft;
+    const int                               size;
+    std::vector<float>                      window;
+
+private:
+    explicit StftPlan (int fftOrder)
+        : fft (FftBackend::create (fftOrder)), size (1 << fftOrder), window (static_cast<size_t> (1 << fftOrder))
+    {
+        juce::dsp::WindowingFunction<float>::fillWindowingTables (
+            window.data(), window.size(), juce::dsp::WindowingFunction<float>::hann);
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (StftPlan)
+};
+
+//==============================================================================
+/**
+ * StftEngine
+ *
+ * Streaming short-time Fourier analysis, with optional overlap-add
+ * resynthesis, of up to a few channels at a configurable size and hop.
+ * Every hop the engine windows and transforms each channel once, then
+ * hands the spectra to its subscribers in registration order. Analysers
+ * read the frame; spectral nodes may rewrite it in place, and the result
+ * is what gets resynthesised. The FFT plan and window come from the
+ * shared StftPlan cache.
+ *
+ * Spectra are interleaved complex, bins 0 … N/2 (see FftBackend).
+ */
+class StftEngine
+{
+public:
+    struct Frame
+    {
+        float* const* spectra     { nullptr }; // one per channel
+        int           numChannels { 0 };
+        int           fftSize     { 0 };
+        int           blockOffset { 0 };       // sample of the current process() call the hop ended on
+
+        int getNumBins() const noexcept { return fftSize / 2 + 1; }
+    };
+
+    class Subscriber
+    {
+    public:
+        virtual ~Subscriber() = default;
+
+        /** Audio thread, once per hop. */
+        virtual void processFrame (Frame& frame) = 0;
+    };
+
+    StftEngine() = default;
+
+    //==============================================================================
+    /** Message thread. With resynthesise off the engine only analyses. */
+    void prepare (int fftOrder, int hop, int channels, bool resynthesise)
+    {
+        plan = StftPlan::get (fftOrder);
+        fftSize = plan->getSize();
+        hopSize = juce::jlimit (1, fftSize, hop);
+        jassert (fftSize % hopSize == 0);
+        numChannels = juce::jlimit (1, MAX_CHANNELS, channels);
+        resynthesis = resynthesise;
+
+        // Synthesis window scaled so analysis × synthesis overlap-adds to unity
+        synthesisWindow.clear();
+        if (resynthesis)
+        {
+            const auto& w = plan->window;
+            double sumSquares = 0.0;
+            for (float v : w) sumSquares += static_cast<double> (v) * v;
+            synthesisWindow.resize (w.size());
+            juce::FloatVectorOperations::copyWithMultiply (
+                synthesisWindow.data(), w.data(), static_cast<float> (hopSize / sumSquares), fftSize);
+        }
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto& c = state[static_cast<size_t> (ch)];
+            c.history.assign (static_cast<size_t> (fftSize), 0.0f);
+            c.spectrum.assign (static_cast<size_t> (fftSize * 2), 0.0f);
+            c.accum.assign (resynthesis ? static_cast<size_t> (fftSize) : 0, 0.0f);
+            c.ready.assign (resynthesis ? static_cast<size_t> (hopSize) : 0, 0.0f);
+            spectra[static_cast<size_t> (ch)] = c.spectrum.data();
+        }
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        for (auto& c : state)
+        {
+            std::fill (c.history.begin(), c.history.end(), 0.0f);
+            std::fill (c.accum.begin(),   c.accum.end(),   0.0f);
+            std::fill (c.ready.begin(),   c.ready.end(),   0.0f);
+        }
+        writePos = 0;
+        hopIndex = 0;
+    }
+
+    /** Message thread, while the engine is not processing. */
+    void addSubscriber (Subscriber* s)    { subscribers.push_back (s); }
+    void removeSubscriber (Subscriber* s) { subscribers.erase (std::remove (subscribers.begin(), subscribers.end(), s),
+                                                               subscribers.end()); }
+
+    /**
+     * Transform two channels as one packed complex FFT (L + i·R) instead of
+     * two real ones. Same spectra within float rounding; halves the
+     * transform count for stereo engines.
+     */
+    void setStereoPacking (bool shouldPack) noexcept { stereoPacking = shouldPack; }
+
+    int getFftSize() const noexcept { return fftSize; }
+    int getHopSize() const noexcept { return hopSize; }
+    int getNumChannels() const noexcept { return numChannels; }
+
+    /** Input-to-output delay of the resynthesised signal. */
+    int getLatencySamples() const noexcept { return resynthesis ? fftSize : 0; }
+
+    //==============================================================================
+    /**
+     * Push numSamples of each channel. When resynthesising, output (which
+     * may alias input) receives the overlap-added signal; otherwise pass
+     * nullptr.
+     */
+    void process (const float* const* input, float* const* output, int numSamples) noexcept
+    {
+        using FVO = juce::FloatVectorOperations;
+
+        for (int done = 0; done < numSamples;)
+        {
+            const int n = juce::jmin (numSamples - done, hopSize - hopIndex);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                auto& c = state[static_cast<size_t> (ch)];
+                FVO::copy (c.history.data() + writePos, input[ch] + done, n);
+                if (output != nullptr && resynthesis)
+                    FVO::copy (output[ch] + done, c.ready.data() + hopIndex, n);
+            }
+
+            done += n;
+            writePos += n;
+            hopIndex += n;
+
+            if (hopIndex == hopSize)
+            {
+                hopIndex = 0;
+                if (writePos == fftSize) writePos = 0;
+                runFrame (done);
+            }
+        }
+    }
+
+private:
+    static constexpr int MAX_CHANNELS = 2;
+
+    void runFrame (int blockOffset) noexcept
+    {
+        using FVO = juce::FloatVectorOperations;
+        const auto& window = plan->window;
+
+        const bool packed = stereoPacking && numChannels == 2;
+
+        // Oldest sample first: the ring from writePos, then its start
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto& c = state[static_cast<size_t> (ch)];
+            float* data = c.spectrum.data();
+            FVO::copy (data, c.history.data() + writePos, fftSize - writePos);
+            FVO::copy (data + (fftSize - writePos), c.history.data(), writePos);
+            FVO::multiply (data, window.data(), fftSize);
+            if (! packed)
+                plan->fft->forward (data);
+        }
+
+        if (packed)
+            plan->fft->forwardStereo (spectra[0], spectra[1]);
+
+        Frame frame { spectra.data(), numChannels, fftSize, blockOffset };
+        for (auto* s : subscribers)
+            s->processFrame (frame);
+
+        if (! resynthesis)
+            return;
+
+        if (packed)
+            plan->fft->inverseStereo (spectra[0], spectra[1]);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto& c = state[static_cast<size_t> (ch)];
+            float* data = c.spectrum.data();
+            if (! packed)
+                plan->fft->inverse (data);
+            FVO::multiply (data, synthesisWindow.data(), fftSize);
+
+            // Overlap-add; the first hop of the accumulator is now complete
+            FVO::add (c.accum.data(), data, fftSize);
+            FVO::copy (c.ready.data(), c.accum.data(), hopSize);
+            std::copy (c.accum.begin() + hopSize, c.accum.end(), c.accum.begin());
+            std::fill (c.accum.end() - hopSize, c.accum.end(), 0.0f);
+        }
+    }
+
+    struct ChannelState
+    {
+        std::vector<float> history;  // ring of the last fftSize input samples
+        std::vector<float> spectrum; // fftSize × 2, as the real-only FFT requires
+        std::vector<float> accum;    // overlap-add accumulator
+        std::vector<float> ready;    // one hop of finished output
+    };
+
+    std::shared_ptr<const StftPlan> plan;
+    std::array<ChannelState, MAX_CHANNELS> state;
+    std::array<float*, MAX_CHANNELS>       spectra {};
+    std::vector<float>                     synthesisWindow;
+    std::vector<Subscriber*>               subscribers;
+
+    int  fftSize       { 0 };
+    int  hopSize       { 1 };
+    int  numChannels   { 1 };
+    int  writePos      { 0 };
+    int  hopIndex      { 0 };
+    bool resynthesis   { false };
+    bool stereoPacking { false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StftEngine)
+};
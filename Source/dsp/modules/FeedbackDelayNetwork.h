@@ -0,0 +1,339 @@
+#pragma once
+#include <JuceHeader.h>
+#include "../SimdDispatch.h"
+
+//==============================================================================
+/**
+ * FeedbackDelayNetwork
+ *
+ * PortalReverb's eight-line tank in structure-of-arrays form. The lines
+ * are interleaved frame by frame in one power-of-two buffer, so the eight
+ * samples at a write position are adjacent: the whole network is written
+ * with one vector store and read with one gather, and the interpolation,
+ * damping and Hadamard mix of all lines are single 8-wide operations.
+ * Every index wraps with a mask.
+ *
+ * The kernel is chosen once, at prepare() time: AVX2, SSE4.1 or scalar.
+ * Each one runs the same per-sample recurrence:
+ *
+ *   mixed  = H₈ · damped                       (last sample's damped outputs)
+ *   out    = line[pos − delay + mod]           (linear interpolation)
+ *   damped = damped · d + out · (1 − d)
+ *   line[pos] = in · inputGain + mixed · feedback + shimmer · shimmerGain
+ *   wet    = mean (out), written to the shimmer buffer
+ *
+ * Each line reads its full length back (pos − delay). The original
+ * per-line ring read at pos + length − 1, which is the previous sample,
+ * so every line was a one-sample loop and the prime lengths only mattered
+ * when drift wrapped the read round the ring. Reading the real lengths
+ * makes the tank a true FDN: the echo density and decay follow the
+ * FDL_PRIMES and Decay as designed. The reverb is longer and smoother,
+ * and it no longer sounds like the original's short metallic ring.
+ */
+class FeedbackDelayNetwork
+{
+public:
+    static constexpr int NUM_LINES = 8;
+
+    /** Per-block settings. The read offsets ramp linearly across the block. */
+    struct BlockParams
+    {
+        float inputGain   { 0.125f };
+        float feedback    { 0.0f };  // includes the 1/√8 Hadamard normalisation
+        float damping     { 0.9f };
+        float shimmerGain { 0.0f };
+        std::array<float, NUM_LINES> modStart {}; // read offset in samples at the first sample
+        std::array<float, NUM_LINES> modStep  {}; // per-sample change of that offset
+    };
+
+    //==============================================================================
+    /** Size the tank for these line lengths plus ±maxModulation samples of drift. */
+    void prepare (const std::array<int, NUM_LINES>& lineLengths, int maxModulation, double sampleRate)
+    {
+        const int longest = *std::max_element (lineLengths.begin(), lineLengths.end());
+        const int frames  = juce::nextPowerOfTwo (longest + maxModulation + 2);
+        lines.assign (static_cast<size_t> (frames * NUM_LINES), 0.0f);
+        mask = frames - 1;
+
+        for (int i = 0; i < NUM_LINES; ++i)
+            delay[static_cast<size_t> (i)] = lineLengths[static_cast<size_t> (i)];
+
+        // Shimmer pitch shifter buffer (~500ms)
+        const int shimmerFrames = juce::nextPowerOfTwo (static_cast<int> (sampleRate * 0.5));
+        shimmerBuf.assign (static_cast<size_t> (shimmerFrames), 0.0f);
+        shimmerMask = shimmerFrames - 1;
+
+        kernel = selectKernel();
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        std::fill (lines.begin(), lines.end(), 0.0f);
+        std::fill (shimmerBuf.begin(), shimmerBuf.end(), 0.0f);
+        damped.fill (0.0f);
+        writePos = 0;
+        shimmerWritePos = 0;
+        shimmerReadPos = 0.0;
+    }
+
+    int getLineLength (int line) const noexcept { return delay[static_cast<size_t> (line)]; }
+
+    /**
+     * Run numSamples of mono input through the tank, writing the stereo
+     * wet signal (mean of the lines, decorrelated by lines 0 and 1).
+     */
+    void process (const float* input, float* wetLeft, float* wetRight,
+                  int numSamples, const BlockParams& params) noexcept
+    {
+        kernel (*this, input, wetLeft, wetRight, numSamples, params);
+    }
+
+private:
+    using Kernel = void (*) (FeedbackDelayNetwork&, const float*, float*, float*, int, const BlockParams&);
+
+    static Kernel selectKernel() noexcept
+    {
+       #if JUCE_INTEL
+        if (juce::SystemStats::hasAVX2())  return &processAVX2;
+        if (juce::SystemStats::hasSSE41()) return &processSSE41;
+       #endif
+        return &processScalar;
+    }
+
+    //==============================================================================
+    /** Octave-up shimmer: read the wet history at 2× speed. */
+    float readShimmer() noexcept
+    {
+        shimmerReadPos += 2.0;
+        const int iPos = static_cast<int> (shimmerReadPos);
+        const float frac = static_cast<float> (shimmerReadPos - iPos);
+        shimmerReadPos -= iPos & ~shimmerMask; // wrap, keeping the fraction
+        const float s0 = shimmerBuf[static_cast<size_t> (iPos & shimmerMask)];
+        const float s1 = shimmerBuf[static_cast<size_t> ((iPos + 1) & shimmerMask)];
+        return s0 + frac * (s1 - s0);
+    }
+
+    void writeShimmer (float wet) noexcept
+    {
+        shimmerBuf[static_cast<size_t> (shimmerWritePos)] = wet;
+        shimmerWritePos = (shimmerWritePos + 1) & shimmerMask;
+    }
+
+    float nextShimmer (float gain) noexcept { return gain > 0.0f ? readShimmer() * gain : 0.0f; }
+
+    static void spread (float wet, float out0, float out1, float& left, float& right) noexcept
+    {
+        left  = wet + out0 * 0.3f - out1 * 0.1f;
+        right = wet - out0 * 0.3f + out1 * 0.1f;
+    }
+
+    //==============================================================================
+    static void processScalar (FeedbackDelayNetwork& fdn, const float* input, float* wetLeft,
+                               float* wetRight, int numSamples, const BlockParams& p) noexcept
+    {
+        float* const buf = fdn.lines.data();
+        const float damp = p.damping, undamp = 1.0f - p.damping;
+
+        for (int n = 0; n < numSamples; ++n)
+        {
+            // Fast 8×8 Walsh–Hadamard mix of last sample's damped outputs
+            float mixed[NUM_LINES];
+            for (int i = 0; i < NUM_LINES; ++i) mixed[i] = fdn.damped[static_cast<size_t> (i)];
+            for (int span = 1; span < NUM_LINES; span <<= 1)
+                for (int i = 0; i < NUM_LINES; ++i)
+                    if ((i & span) == 0)
+                    {
+                        const float a = mixed[i], b = mixed[i + span];
+                        mixed[i] = a + b;
+                        mixed[i + span] = a - b;
+                    }
+
+            const float common = input[n] * p.inputGain + fdn.nextShimmer (p.shimmerGain);
+            const float modN = static_cast<float> (n);
+            float* const frame = buf + fdn.writePos * NUM_LINES;
+            float out[NUM_LINES];
+            float wet = 0.0f;
+
+            for (int i = 0; i < NUM_LINES; ++i)
+            {
+                const auto li = static_cast<size_t> (i);
+                const float mod = p.modStart[li] + p.modStep[li] * modN;
+                const float fl = std::floor (mod);
+                const int r0 = (fdn.writePos - fdn.delay[li] + static_cast<int> (fl)) & fdn.mask;
+                const int r1 = (r0 + 1) & fdn.mask;
+                const float s0 = buf[r0 * NUM_LINES + i];
+                const float s1 = buf[r1 * NUM_LINES + i];
+                out[i] = s0 + (mod - fl) * (s1 - s0);
+
+                fdn.damped[li] = fdn.damped[li] * damp + out[i] * undamp;
+                frame[i] = common + mixed[i] * p.feedback;
+                wet += out[i];
+            }
+
+            wet *= 1.0f / NUM_LINES;
+            fdn.writeShimmer (wet);
+            spread (wet, out[0], out[1], wetLeft[n], wetRight[n]);
+            fdn.writePos = (fdn.writePos + 1) & fdn.mask;
+        }
+    }
+
+   #if JUCE_INTEL
+    //==============================================================================
+    /** Butterfly stages of span 1 and 2 within one half of the network. */
+    SNOT_TARGET_ISA ("sse4.1")
+    static __m128 butterfly4 (__m128 h, __m128 sign1, __m128 sign2) noexcept
+    {
+        h = _mm_add_ps (_mm_mul_ps (h, sign1), _mm_shuffle_ps (h, h, _MM_SHUFFLE (2, 3, 0, 1)));
+        return _mm_add_ps (_mm_mul_ps (h, sign2), _mm_shuffle_ps (h, h, _MM_SHUFFLE (1, 0, 3, 2)));
+    }
+
+    /** Interpolated read of four lines; below AVX2 the gather is scalar loads. */
+    SNOT_TARGET_ISA ("sse4.1")
+    static __m128 read4 (const float* buf, int writePos, __m128 mod, __m128i lineDelay,
+                         __m128i maskV, int firstLine) noexcept
+    {
+        const __m128 fl = _mm_floor_ps (mod);
+        const __m128i base = _mm_sub_epi32 (_mm_set1_epi32 (writePos), lineDelay);
+        const __m128i r0 = _mm_and_si128 (_mm_add_epi32 (base, _mm_cvttps_epi32 (fl)), maskV);
+        const __m128i r1 = _mm_and_si128 (_mm_add_epi32 (r0, _mm_set1_epi32 (1)), maskV);
+
+        alignas (16) int i0[4], i1[4];
+        _mm_store_si128 (reinterpret_cast<__m128i*> (i0), r0);
+        _mm_store_si128 (reinterpret_cast<__m128i*> (i1), r1);
+        const float* b = buf + firstLine;
+        const __m128 s0 = _mm_setr_ps (b[i0[0] * NUM_LINES],     b[i0[1] * NUM_LINES + 1],
+                                       b[i0[2] * NUM_LINES + 2], b[i0[3] * NUM_LINES + 3]);
+        const __m128 s1 = _mm_setr_ps (b[i1[0] * NUM_LINES],     b[i1[1] * NUM_LINES + 1],
+                                       b[i1[2] * NUM_LINES + 2], b[i1[3] * NUM_LINES + 3]);
+        return _mm_add_ps (s0, _mm_mul_ps (_mm_sub_ps (mod, fl), _mm_sub_ps (s1, s0)));
+    }
+
+    SNOT_TARGET_ISA ("sse4.1")
+    static void processSSE41 (FeedbackDelayNetwork& fdn, const float* input, float* wetLeft,
+                              float* wetRight, int numSamples, const BlockParams& p) noexcept
+    {
+        // Lines 0–3 in lo, 4–7 in hi
+        float* const buf = fdn.lines.data();
+        const __m128 sign1  = _mm_setr_ps (1.0f, -1.0f, 1.0f, -1.0f);
+        const __m128 sign2  = _mm_setr_ps (1.0f, 1.0f, -1.0f, -1.0f);
+        const __m128 damp   = _mm_set1_ps (p.damping);
+        const __m128 undamp = _mm_set1_ps (1.0f - p.damping);
+        const __m128 fb     = _mm_set1_ps (p.feedback);
+        const __m128i maskV = _mm_set1_epi32 (fdn.mask);
+        const __m128i delayLo = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (fdn.delay.data()));
+        const __m128i delayHi = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (fdn.delay.data() + 4));
+
+        __m128 modLo = _mm_loadu_ps (p.modStart.data()), modHi = _mm_loadu_ps (p.modStart.data() + 4);
+        const __m128 stepLo = _mm_loadu_ps (p.modStep.data()), stepHi = _mm_loadu_ps (p.modStep.data() + 4);
+        __m128 dampedLo = _mm_loadu_ps (fdn.damped.data()), dampedHi = _mm_loadu_ps (fdn.damped.data() + 4);
+
+        for (int n = 0; n < numSamples; ++n)
+        {
+            const __m128 a = butterfly4 (dampedLo, sign1, sign2), b = butterfly4 (dampedHi, sign1, sign2);
+            const __m128 mixedLo = _mm_add_ps (a, b), mixedHi = _mm_sub_ps (a, b); // span 4
+
+            const __m128 outLo = read4 (buf, fdn.writePos, modLo, delayLo, maskV, 0);
+            const __m128 outHi = read4 (buf, fdn.writePos, modHi, delayHi, maskV, 4);
+
+            dampedLo = _mm_add_ps (_mm_mul_ps (dampedLo, damp), _mm_mul_ps (outLo, undamp));
+            dampedHi = _mm_add_ps (_mm_mul_ps (dampedHi, damp), _mm_mul_ps (outHi, undamp));
+
+            const __m128 common = _mm_set1_ps (input[n] * p.inputGain + fdn.nextShimmer (p.shimmerGain));
+            float* const frame = buf + fdn.writePos * NUM_LINES;
+            _mm_storeu_ps (frame,     _mm_add_ps (common, _mm_mul_ps (mixedLo, fb)));
+            _mm_storeu_ps (frame + 4, _mm_add_ps (common, _mm_mul_ps (mixedHi, fb)));
+
+            __m128 sum = _mm_add_ps (outLo, outHi);
+            sum = _mm_add_ps (sum, _mm_movehl_ps (sum, sum));
+            sum = _mm_add_ss (sum, _mm_shuffle_ps (sum, sum, 1));
+            const float wet = _mm_cvtss_f32 (sum) * (1.0f / NUM_LINES);
+
+            fdn.writeShimmer (wet);
+            spread (wet, _mm_cvtss_f32 (outLo), _mm_cvtss_f32 (_mm_shuffle_ps (outLo, outLo, 1)),
+                    wetLeft[n], wetRight[n]);
+
+            fdn.writePos = (fdn.writePos + 1) & fdn.mask;
+            modLo = _mm_add_ps (modLo, stepLo);
+            modHi = _mm_add_ps (modHi, stepHi);
+        }
+
+        _mm_storeu_ps (fdn.damped.data(),     dampedLo);
+        _mm_storeu_ps (fdn.damped.data() + 4, dampedHi);
+    }
+
+    //==============================================================================
+    SNOT_TARGET_ISA ("avx2")
+    static void processAVX2 (FeedbackDelayNetwork& fdn, const float* input, float* wetLeft,
+                             float* wetRight, int numSamples, const BlockParams& p) noexcept
+    {
+        float* const buf = fdn.lines.data();
+        const __m256 sign1  = _mm256_setr_ps (1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f);
+        const __m256 sign2  = _mm256_setr_ps (1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, -1.0f, -1.0f);
+        const __m256 sign4  = _mm256_setr_ps (1.0f, 1.0f, 1.0f, 1.0f, -1.0f, -1.0f, -1.0f, -1.0f);
+        const __m256 damp   = _mm256_set1_ps (p.damping);
+        const __m256 undamp = _mm256_set1_ps (1.0f - p.damping);
+        const __m256 fb     = _mm256_set1_ps (p.feedback);
+        const __m256i maskV = _mm256_set1_epi32 (fdn.mask);
+        const __m256i one   = _mm256_set1_epi32 (1);
+        const __m256i lane  = _mm256_setr_epi32 (0, 1, 2, 3, 4, 5, 6, 7);
+        const __m256i lineDelay = _mm256_loadu_si256 (reinterpret_cast<const __m256i*> (fdn.delay.data()));
+
+        __m256 mod = _mm256_loadu_ps (p.modStart.data());
+        const __m256 step = _mm256_loadu_ps (p.modStep.data());
+        __m256 dampedV = _mm256_loadu_ps (fdn.damped.data());
+
+        for (int n = 0; n < numSamples; ++n)
+        {
+            // Walsh–Hadamard: each stage is x·sign + partner, partner = lane ^ span
+            __m256 mixed = dampedV;
+            mixed = _mm256_add_ps (_mm256_mul_ps (mixed, sign1), _mm256_permute_ps (mixed, 0xB1));
+            mixed = _mm256_add_ps (_mm256_mul_ps (mixed, sign2), _mm256_permute_ps (mixed, 0x4E));
+            mixed = _mm256_add_ps (_mm256_mul_ps (mixed, sign4), _mm256_permute2f128_ps (mixed, mixed, 0x01));
+
+            // Gather all eight interpolated reads
+            const __m256 fl = _mm256_floor_ps (mod);
+            const __m256i base = _mm256_sub_epi32 (_mm256_set1_epi32 (fdn.writePos), lineDelay);
+            const __m256i r0 = _mm256_and_si256 (_mm256_add_epi32 (base, _mm256_cvttps_epi32 (fl)), maskV);
+            const __m256i r1 = _mm256_and_si256 (_mm256_add_epi32 (r0, one), maskV);
+            const __m256 s0 = _mm256_i32gather_ps (buf, _mm256_add_epi32 (_mm256_slli_epi32 (r0, 3), lane), 4);
+            const __m256 s1 = _mm256_i32gather_ps (buf, _mm256_add_epi32 (_mm256_slli_epi32 (r1, 3), lane), 4);
+            const __m256 out = _mm256_add_ps (s0, _mm256_mul_ps (_mm256_sub_ps (mod, fl), _mm256_sub_ps (s1, s0)));
+
+            dampedV = _mm256_add_ps (_mm256_mul_ps (dampedV, damp), _mm256_mul_ps (out, undamp));
+
+            const __m256 common = _mm256_set1_ps (input[n] * p.inputGain + fdn.nextShimmer (p.shimmerGain));
+            _mm256_storeu_ps (buf + fdn.writePos * NUM_LINES, _mm256_add_ps (common, _mm256_mul_ps (mixed, fb)));
+
+            const __m128 lo = _mm256_castps256_ps128 (out);
+            __m128 sum = _mm_add_ps (lo, _mm256_extractf128_ps (out, 1));
+            sum = _mm_add_ps (sum, _mm_movehl_ps (sum, sum));
+            sum = _mm_add_ss (sum, _mm_shuffle_ps (sum, sum, 1));
+            const float wet = _mm_cvtss_f32 (sum) * (1.0f / NUM_LINES);
+
+            fdn.writeShimmer (wet);
+            spread (wet, _mm_cvtss_f32 (lo), _mm_cvtss_f32 (_mm_shuffle_ps (lo, lo, 1)),
+                    wetLeft[n], wetRight[n]);
+
+            fdn.writePos = (fdn.writePos + 1) & fdn.mask;
+            mod = _mm256_add_ps (mod, step);
+        }
+
+        _mm256_storeu_ps (fdn.damped.data(), dampedV);
+    }
+   #endif
+
+    //==============================================================================
+    std::vector<float> lines;              // frames of NUM_LINES interleaved samples
+    int mask     { 0 };
+    int writePos { 0 };
+    alignas (32) std::array<int,   NUM_LINES> delay  {};
+    alignas (32) std::array<float, NUM_LINES> damped {};
+
+    std::vector<float> shimmerBuf;
+    int    shimmerMask     { 0 };
+    int    shimmerWritePos { 0 };
+    double shimmerReadPos  { 0.0 };
+
+    Kernel kernel { &processScalar };
+};
@@ -17,21 +17,17 @@
  * Pre/post LPF prevents aliasing aliasing (run at 4x oversampling recommended).
  * Anti-aliasing filter: 4th-order Butterworth at Nyquist/2.
  */
-class PlasmaDistortion : public AudioNode
+class PlasmaDistortion final : public AudioNode
 {
 public:
-    explicit PlasmaDistortion (juce::AudioProcessorValueTreeState& apvts) : apvts (apvts)
-    {
-        pDrive     = apvts.getRawParameterValue (ParamID::PD_DRIVE);
-        pCharacter = apvts.getRawParameterValue (ParamID::PD_CHARACTER);
-        pBias      = apvts.getRawParameterValue (ParamID::PD_BIAS);
-        pMix       = apvts.getRawParameterValue (ParamID::PD_MIX);
-        pEnabled   = apvts.getRawParameterValue (ParamID::PD_ENABLED);
-    }
+    explicit PlasmaDistortion (juce::AudioProcessorValueTreeState& apvts) : apvts (apvts) {}
 
     juce::String getName() const override { return "Plasma Distortion"; }
     juce::String getType() const override { return "plasma_distortion"; }
 
+    double getTailLengthSeconds (const ParameterValues*, const ModulationBuses*) const override { return 0.01; } // anti-alias filter only
+    int    getOversamplingFactor() const override { return 8; }    // up to 40x drive
+
     void prepare (const juce::dsp::ProcessSpec& spec) override
     {
         antiAlias.prepare (spec);
@@ -40,26 +36,37 @@ public:
         antiAlias.setResonance (0.5);
         dryBuf.setSize (static_cast<int>(spec.numChannels),
                         static_cast<int>(spec.maximumBlockSize));
+        smoother.prepare (spec.sampleRate, static_cast<int>(spec.maximumBlockSize));
+        mixer.prepare (static_cast<int>(spec.maximumBlockSize));
     }
 
-    void reset() override { antiAlias.reset(); }
+    void reset() override { antiAlias.reset(); smoother.reset(); mixer.reset(); }
 
-    void process (juce::dsp::AudioBlock<float>& block) override
+    void render (const NodeContext& context) noexcept override
     {
-        if (!isEnabled() || pEnabled->load() < 0.5f) return;
-
-        const float drive     = juce::jmap (pDrive->load(),     0.0f, 1.0f, 1.0f,  40.0f);
-        const float character = pCharacter->load();
-        const float bias      = pBias->load() * 0.5f;
-        const float mix       = pMix->load();
-        const float outGain   = 1.0f / std::sqrt (drive); // compensate loudness
-
-        for (int ch = 0; ch < (int)block.getNumChannels(); ++ch)
+        if (! isActive (context, ParamIndex::PD_ENABLED)) return;
+
+        const int numSamples = context.numSamples;
+
+        // Drive and mix are smoothed per sample; the loudness
+        // compensation is interpolated between the block's end points
+        smoother.process (context.parameters, context.modulation, numSamples);
+        const float* driveNorm = smoother.get (driveSlot);
+        mixer.update (smoother, mixSlot, numSamples);
+        const float  drive0    = juce::jmap (driveNorm[0],              0.0f, 1.0f, 1.0f, 40.0f);
+        const float  drive1    = juce::jmap (driveNorm[juce::jmax (0, numSamples - 1)], 0.0f, 1.0f, 1.0f, 40.0f);
+        const ModulatedParameter::Ramp outGain { 1.0f / std::sqrt (drive0), // compensate loudness
+                                                 (1.0f / std::sqrt (drive1) - 1.0f / std::sqrt (drive0)) / (float)numSamples };
+        const float character = pCharacter.getValue (context.parameters, context.modulation);
+        const float bias      = pBias.getValue (context.parameters, context.modulation) * 0.5f;
+
+        for (int ch = 0; ch < context.numChannels; ++ch)
         {
-            for (int s = 0; s < (int)block.getNumSamples(); ++s)
+            float* SNOT_RESTRICT io = context.channel (ch);
+            for (int s = 0; s < numSamples; ++s)
             {
-                const float dry = block.getSample (ch, s);
-                float x = dry * drive + bias;
+                const float dry = io[s];
+                float x = dry * juce::jmap (driveNorm[s], 0.0f, 1.0f, 1.0f, 40.0f) + bias;
 
                 // Plasma transfer function
                 const float tanhX = softClip (x);
@@ -68,9 +75,9 @@ public:
 
                 // Anti-aliasing filter output
                 const float filtered = antiAlias.processSample (ch, plasma);
-                const float wet = filtered * outGain;
+                const float wet = filtered * outGain.at (s);
 
-                block.setSample (ch, s, eqpCrossfade (dry, wet, mix));
+                io[s] = mixer.mixSample (dry, wet, s);
             }
         }
     }
@@ -80,11 +87,14 @@ private:
     juce::dsp::StateVariableTPTFilter<float> antiAlias;
     juce::AudioBuffer<float> dryBuf;
 
-    std::atomic<float>* pDrive     { nullptr };
-    std::atomic<float>* pCharacter { nullptr };
-    std::atomic<float>* pBias      { nullptr };
-    std::atomic<float>* pMix       { nullptr };
-    std::atomic<float>* pEnabled   { nullptr };
+    ModulatedParameter  pDrive     { apvts, ParamIndex::PD_DRIVE };
+    ModulatedParameter  pCharacter { apvts, ParamIndex::PD_CHARACTER };
+    ModulatedParameter  pBias      { apvts, ParamIndex::PD_BIAS };
+    ModulatedParameter  pMix       { apvts, ParamIndex::PD_MIX };
+    ParameterSmoother   smoother;
+    const int driveSlot { smoother.add (pDrive) };
+    const int mixSlot   { smoother.add (pMix) };
+    EqualPowerMix       mixer;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PlasmaDistortion)
 };
@@ -101,21 +111,21 @@ private:
  * signal → frequency pulled up. Low signal → frequency pulled down.
  * The "curve" parameter controls the nonlinearity of this modulation.
  */
-class GravityCurveFilter : public AudioNode
+class GravityCurveFilter final : public AudioNode
 {
 public:
-    explicit GravityCurveFilter (juce::AudioProcessorValueTreeState& apvts) : apvts (apvts)
-    {
-        pFreq    = apvts.getRawParameterValue (ParamID::GF_FREQ);
-        pReso    = apvts.getRawParameterValue (ParamID::GF_RESO);
-        pCurve   = apvts.getRawParameterValue (ParamID::GF_CURVE);
-        pMode    = apvts.getRawParameterValue (ParamID::GF_MODE);
-        pEnabled = apvts.getRawParameterValue (ParamID::GF_ENABLED);
-    }
+    explicit GravityCurveFilter (juce::AudioProcessorValueTreeState& apvts) : apvts (apvts) {}
 
     juce::String getName() const override { return "Gravity Curve Filter"; }
     juce::String getType() const override { return "gravity_filter"; }
 
+    /** Resonance rings longest at the bottom of the sweep: ~Q/(π·20 Hz)·ln(1e5). */
+    double getTailLengthSeconds (const ParameterValues* values, const ModulationBuses* buses) const override
+    {
+        const double q = juce::jmap (static_cast<double> (pReso.getMaxValue (values, buses)), 0.0, 1.0, 0.5, 20.0);
+        return 0.05 + q * 0.18;
+    }
+
     void prepare (const juce::dsp::ProcessSpec& spec) override
     {
         sampleRate = spec.sampleRate;
@@ -124,18 +134,22 @@ public:
         rmsSmooth = 0.0f;
         const float timeConst = std::exp (-1.0f / (0.02f * static_cast<float>(spec.sampleRate)));
         rmsCoeff = timeConst;
+        smoother.prepare (spec.sampleRate, static_cast<int>(spec.maximumBlockSize));
     }
 
-    void reset() override { filter.reset(); rmsSmooth = 0.0f; }
+    void reset() override { filter.reset(); rmsSmooth = 0.0f; smoother.reset(); }
 
-    void process (juce::dsp::AudioBlock<float>& block) override
+    void render (const NodeContext& context) noexcept override
     {
-        if (!isEnabled() || pEnabled->load() < 0.5f) return;
+        if (! isActive (context, ParamIndex::GF_ENABLED)) return;
 
-        const float baseFreq = pFreq->load();
-        const float reso     = juce::jmap (pReso->load(), 0.0f, 1.0f, 0.5f, 20.0f);
-        const float curve    = pCurve->load();
-        const int   modeInt  = static_cast<int> (pMode->load());
+        const int numSamples  = context.numSamples;
+        const int numChannels = context.numChannels;
+        smoother.process (context.parameters, context.modulation, numSamples);
+        const float* freq    = smoother.get (freqSlot);
+        const float reso     = juce::jmap (pReso.getValue (context.parameters, context.modulation), 0.0f, 1.0f, 0.5f, 20.0f);
+        const float curve    = pCurve.getValue (context.parameters, context.modulation);
+        const int   modeInt  = static_cast<int> (context.getParameter (ParamIndex::GF_MODE));
 
         using SVF = juce::dsp::StateVariableTPTFilterType;
         const SVF modeMap[] = { SVF::lowpass, SVF::highpass, SVF::bandpass,
@@ -143,17 +157,32 @@ public:
         filter.setType (modeMap[modeInt]);
         filter.setResonance (reso);
 
-        for (int s = 0; s < (int)block.getNumSamples(); ++s)
+        // The detector is linked across channels: one power sum per frame
+        using StereoLanes::float2;
+        float* const* io = context.channels;
+        const bool stereo = numChannels == 2;
+
+        for (int s = 0; s < numSamples; ++s)
         {
             // Compute per-sample RMS (smooth)
             float power = 0.0f;
-            for (int ch = 0; ch < (int)block.getNumChannels(); ++ch)
-                power += block.getSample (ch, s) * block.getSample (ch, s);
-            power /= block.getNumChannels();
+            if (stereo)
+            {
+                const float2 x  = float2::load (io[0], io[1], s);
+                const float2 x2 = x * x;
+                power = (x2.l + x2.r) * 0.5f;
+            }
+            else
+            {
+                for (int ch = 0; ch < numChannels; ++ch)
+                    power += io[ch][s] * io[ch][s];
+                power /= static_cast<float> (numChannels);
+            }
             rmsSmooth = rmsSmooth * rmsCoeff + power * (1.0f - rmsCoeff);
             const float rms = std::sqrt (rmsSmooth);
 
             // Gravity: cutoff modulated by input level + curve nonlinearity
+            const float baseFreq = freq[s];
             float modFreq = baseFreq;
             if (modeInt == 4) // Gravity mode
             {
@@ -163,11 +192,8 @@ public:
             }
             filter.setCutoffFrequency (modFreq);
 
-            for (int ch = 0; ch < (int)block.getNumChannels(); ++ch)
-            {
-                const float out = filter.processSample (ch, block.getSample (ch, s));
-                block.setSample (ch, s, out);
-            }
+            for (int ch = 0; ch < numChannels; ++ch)
+                io[ch][s] = filter.processSample (ch, io[ch][s]);
         }
     }
 
@@ -175,11 +201,11 @@ private:
     juce::AudioProcessorValueTreeState& apvts;
     juce::dsp::StateVariableTPTFilter<float> filter;
 
-    std::atomic<float>* pFreq    { nullptr };
-    std::atomic<float>* pReso    { nullptr };
-    std::atomic<float>* pCurve   { nullptr };
-    std::atomic<float>* pMode    { nullptr };
-    std::atomic<float>* pEnabled { nullptr };
+    ModulatedParameter  pFreq    { apvts, ParamIndex::GF_FREQ };
+    ModulatedParameter  pReso    { apvts, ParamIndex::GF_RESO };
+    ModulatedParameter  pCurve   { apvts, ParamIndex::GF_CURVE };
+    ParameterSmoother   smoother;
+    const int freqSlot { smoother.add (pFreq) };
 
     double sampleRate { 44100.0 };
     float  rmsSmooth  { 0.0f };
@@ -201,22 +227,17 @@ private:
  * The combination creates that "bouncy" glo trap 808 that hits hard,
  * has presence at all volumes, and glides with rich harmonic content.
  */
-class Harmonic808Inflator : public AudioNode
+class Harmonic808Inflator final : public AudioNode
 {
 public:
-    explicit Harmonic808Inflator (juce::AudioProcessorValueTreeState& apvts) : apvts (apvts)
-    {
-        pDrive   = apvts.getRawParameterValue (ParamID::H8_DRIVE);
-        pPunch   = apvts.getRawParameterValue (ParamID::H8_PUNCH);
-        pBloom   = apvts.getRawParameterValue (ParamID::H8_BLOOM);
-        pTune    = apvts.getRawParameterValue (ParamID::H8_TUNE);
-        pMix     = apvts.getRawParameterValue (ParamID::H8_MIX);
-        pEnabled = apvts.getRawParameterValue (ParamID::H8_ENABLED);
-    }
+    explicit Harmonic808Inflator (juce::AudioProcessorValueTreeState& apvts) : apvts (apvts) {}
 
     juce::String getName() const override { return "Harmonic 808 Inflator"; }
     juce::String getType() const override { return "harmonic_808_inflator"; }
 
+    double getTailLengthSeconds (const ParameterValues*, const ModulationBuses*) const override { return 0.1; } // envelope release
+    int    getOversamplingFactor() const override { return 4; }  // gentler saturation
+
     void prepare (const juce::dsp::ProcessSpec& spec) override
     {
         sampleRate = spec.sampleRate;
@@ -234,25 +255,31 @@ public:
         const float releaseMs = 100.0f;
         envAttack  = std::exp (-1.0f / (attackMs  * 0.001f * static_cast<float>(sampleRate)));
         envRelease = std::exp (-1.0f / (releaseMs * 0.001f * static_cast<float>(sampleRate)));
+        smoother.prepare (spec.sampleRate, static_cast<int>(spec.maximumBlockSize));
+        mixer.prepare (static_cast<int>(spec.maximumBlockSize));
     }
 
-    void reset() override { bloomHPF.reset(); envSmooth = 0.0f; }
+    void reset() override { bloomHPF.reset(); envSmooth = 0.0f; smoother.reset(); mixer.reset(); }
 
-    void process (juce::dsp::AudioBlock<float>& block) override
+    void render (const NodeContext& context) noexcept override
     {
-        if (!isEnabled() || pEnabled->load() < 0.5f) return;
-
-        const float drive   = juce::jmap (pDrive->load(), 0.0f, 1.0f, 1.0f, 8.0f);
-        const float punch   = pPunch->load();
-        const float bloom   = pBloom->load();
-        const float mix     = pMix->load();
+        if (! isActive (context, ParamIndex::H8_ENABLED)) return;
+
+        const int   numSamples = context.numSamples;
+        smoother.process (context.parameters, context.modulation, numSamples);
+        const float* driveNorm = smoother.get (driveSlot);
+        mixer.update (smoother, mixSlot, numSamples);
+        const float  punch     = pPunch.getValue (context.parameters, context.modulation);
+        const float  bloom     = pBloom.getValue (context.parameters, context.modulation);
         // Tune handled at block level (would use PSOLA in production)
 
-        for (int ch = 0; ch < (int)block.getNumChannels(); ++ch)
+        for (int ch = 0; ch < context.numChannels; ++ch)
         {
-            for (int s = 0; s < (int)block.getNumSamples(); ++s)
+            float* SNOT_RESTRICT io = context.channel (ch);
+            for (int s = 0; s < numSamples; ++s)
             {
-                const float dry = block.getSample (ch, s);
+                const float dry = io[s];
+                const float driveGain = juce::jmap (driveNorm[s], 0.0f, 1.0f, 1.0f, 8.0f);
 
                 // Envelope follower for transient punch
                 const float rectified = std::abs (dry);
@@ -261,7 +288,7 @@ public:
                     : rectified * (1 - envRelease) + envSmooth * envRelease;
 
                 // Drive → soft saturation
-                float x = softClip (dry * drive);
+                float x = softClip (dry * driveGain);
 
                 // 2nd harmonic injection (punch)
                 const float h2 = x * x * (x > 0 ? 1.0f : -1.0f); // asymmetric 2nd harmonic
@@ -272,9 +299,9 @@ public:
                 x += bloomSig * bloom * 0.3f;
 
                 // Output gain compensation
-                x *= 1.0f / drive;
+                x *= 1.0f / driveGain;
 
-                block.setSample (ch, s, eqpCrossfade (dry, x, mix));
+                io[s] = mixer.mixSample (dry, x, s);
             }
         }
     }
@@ -284,12 +311,14 @@ private:
     juce::dsp::StateVariableTPTFilter<float> bloomHPF;
     juce::AudioBuffer<float> dryBuf;
 
-    std::atomic<float>* pDrive   { nullptr };
-    std::atomic<float>* pPunch   { nullptr };
-    std::atomic<float>* pBloom   { nullptr };
-    std::atomic<float>* pTune    { nullptr };
-    std::atomic<float>* pMix     { nullptr };
-    std::atomic<float>* pEnabled { nullptr };
+    ModulatedParameter  pDrive   { apvts, ParamIndex::H8_DRIVE };
+    ModulatedParameter  pPunch   { apvts, ParamIndex::H8_PUNCH };
+    ModulatedParameter  pBloom   { apvts, ParamIndex::H8_BLOOM };
+    ModulatedParameter  pMix     { apvts, ParamIndex::H8_MIX };
+    ParameterSmoother   smoother;
+    const int driveSlot { smoother.add (pDrive) };
+    const int mixSlot   { smoother.add (pMix) };
+    EqualPowerMix       mixer;
 
     double sampleRate  { 44100.0 };
     float  envSmooth   { 0.0f };
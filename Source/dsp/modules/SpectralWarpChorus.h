@@ -1,5 +1,7 @@
 #pragma once
 #include "../AudioNode.h"
+#include "../SpectralOps.h"
+#include "../StftEngine.h"
 #include "../../PluginProcessor.h"
 
 //==============================================================================
@@ -16,36 +18,64 @@
  * any time-domain approach — voices don't sound like copies, they sound
  * like parallel versions of the audio from different dimensions.
  *
- * FFT size: 2048 samples, hop: 512 (75% overlap), Hann window.
+ * Every voice is a per-bin phase rotation and gain of the same spectrum,
+ * so the voice sum collapses to one complex gain per bin, applied with a
+ * single SIMD complex multiply. The voices' rotors depend only on depth,
+ * warp and voice count; their LFOs share one rate at fixed phase offsets,
+ * so any LFO position is a blend of three precomputed rotor sums. Per-hop
+ * cost does not grow with SWC_VOICES.
+ *
+ * SWC_FRAME picks the analysis size: 256, 512, 1024 or 2048 samples, hop
+ * = size / 4 (75% overlap), Hann window, analysed and resynthesised by a
+ * StftEngine. The dry path is delayed by one frame so it lines up with
+ * the wet, and that frame is the latency the node reports. Rotor phases
+ * are laid out on the 2048-point bin grid, so the voices keep their
+ * character at every size.
+ *
+ * Changing SWC_FRAME keeps the old size playing while the new one fills
+ * with signal (two of its frames). Then wet and dry crossfade from the old
+ * size's output and delay to the new one's over a hop of the longer frame.
+ * A change that arrives mid-fade is taken up once the fade completes.
+ *
+ * Hybrid runs the voices through a 2048-point frame below
+ * HYBRID_CROSSOVER_HZ and a 256-point frame above it, split by
+ * complementary raised-cosine bin weights an octave wide. The unchorused
+ * signal passes through the 256-point frame alone, so at depth 0 Hybrid is
+ * a clean 256-sample delay with no comb across the crossover. Only the
+ * short frame counts towards latency, so the dry path and the highs stay
+ * tight for live use. The price is that the chorus on the lows lags the
+ * rest by the difference (1792 samples, about 37 ms at 48 kHz). The Frame
+ * choice is labelled "Hybrid (lows lag)" to say so.
  */
-class SpectralWarpChorus : public AudioNode
+class SpectralWarpChorus final : public AudioNode
 {
 public:
-    static constexpr int FFT_ORDER  = 11;  // 2048
-    static constexpr int FFT_SIZE   = 1 << FFT_ORDER;
-    static constexpr int HOP_SIZE   = FFT_SIZE / 4;  // 75% overlap
-    static constexpr int MAX_VOICES = 8;
+    static constexpr int   MIN_FFT_ORDER       = 8;   // 256
+    static constexpr int   MAX_FFT_ORDER       = 11;  // 2048
+    static constexpr int   MAX_FFT_SIZE        = 1 << MAX_FFT_ORDER;
+    static constexpr int   MAX_VOICES          = 8;
+    static constexpr float HYBRID_CROSSOVER_HZ = 700.0f;
+
+    /** SWC_FRAME choices: one frame size each, then the two-band hybrid. */
+    enum FrameMode { frame256, frame512, frame1024, frame2048, hybrid, numFrameModes };
 
     explicit SpectralWarpChorus (juce::AudioProcessorValueTreeState& apvts)
-        : apvts (apvts),
-          fft (FFT_ORDER),
-          window (FFT_SIZE, juce::dsp::WindowingFunction<float>::hann)
+        : apvts (apvts)
     {
-        pDepth   = apvts.getRawParameterValue (ParamID::SWC_DEPTH);
-        pRate    = apvts.getRawParameterValue (ParamID::SWC_RATE);
-        pVoices  = apvts.getRawParameterValue (ParamID::SWC_VOICES);
-        pWarp    = apvts.getRawParameterValue (ParamID::SWC_WARP);
-        pMix     = apvts.getRawParameterValue (ParamID::SWC_MIX);
+        for (auto& r : resolutions)
+            r = std::make_unique<Resolution> (*this);
+
+        pFrame   = apvts.getRawParameterValue (ParamID::SWC_FRAME);
         pEnabled = apvts.getRawParameterValue (ParamID::SWC_ENABLED);
 
         // Seed per-voice random state
         for (int v = 0; v < MAX_VOICES; ++v)
         {
-            voiceLfoPhase[v] = static_cast<float>(v) / MAX_VOICES;
+            voiceLfoOffset[v] = static_cast<float>(v) / MAX_VOICES;
             voiceDetune[v]   = (v % 2 == 0 ? 1.0f : -1.0f)
                              * (0.1f + 0.15f * static_cast<float>(v));
             random.setSeed (v * 0x9e3779b9 + 12345678);
-            for (int b = 0; b < FFT_SIZE / 2; ++b)
+            for (int b = 0; b < MAX_FFT_SIZE / 2; ++b)
                 voicePhaseRand[v][b % 512] = random.nextFloat() * juce::MathConstants<float>::twoPi;
         }
     }
@@ -53,153 +83,496 @@ public:
     juce::String getName() const override { return "Spectral Warp Chorus"; }
     juce::String getType() const override { return "spectral_warp_chorus"; }
 
+    /** One frame in flight in the input FIFO plus one in the overlap-add tail. */
+    double getTailLengthSeconds (const ParameterValues*, const ModulationBuses*) const override
+    {
+        return 2.0 * MAX_FFT_SIZE / sampleRate;
+    }
+
+    /** The selected frame, or 0 while bypassed (the dry path is then undelayed). */
+    int getLatencySamples() const override
+    {
+        if (! isEnabled() || pEnabled->load() < 0.5f)
+            return 0;
+        return resolutions[static_cast<size_t> (primaryResolution (getFrameMode()))]->getLatencySamples();
+    }
+
+    /** The frame the last block was heard through: the incoming one once a mode fade passes halfway. */
+    int getBlockLatencySamples() const override { return blockLatency; }
+
     //==============================================================================
     void prepare (const juce::dsp::ProcessSpec& spec) override
     {
         sampleRate  = spec.sampleRate;
         numChannels = static_cast<int> (spec.numChannels);
 
-        for (int ch = 0; ch < 2; ++ch)
-        {
-            inFifo[ch].assign (FFT_SIZE, 0.0f);
-            outFifo[ch].assign (FFT_SIZE, 0.0f);
-            fftData[ch].assign (FFT_SIZE * 2, 0.0f);
-            outputAccum[ch].assign (FFT_SIZE + HOP_SIZE, 0.0f);
-        }
-        fifoIndex = 0;
+        // Every mode is prepared up front so SWC_FRAME switches without allocating
+        const int channels = juce::jmin (numChannels, 2);
+        for (int mode = frame256; mode <= frame2048; ++mode)
+            resolutions[static_cast<size_t> (mode)]->prepare (MIN_FFT_ORDER + mode, channels, Band::full);
+        resolutions[hybridHigh]->prepare (MIN_FFT_ORDER, channels, Band::high);
+        resolutions[hybridLow] ->prepare (MAX_FFT_ORDER, channels, Band::low);
+
+        const int maxBlock = static_cast<int> (spec.maximumBlockSize);
+        wetBuf.setSize (2, maxBlock);
+        fadeBuf.setSize (2, maxBlock);
+        hybridBuf.setSize (2, maxBlock);
+        fadeGains.assign (static_cast<size_t> (maxBlock), 0.0f);
+        dryDelay.setSize (2, juce::nextPowerOfTwo (MAX_FFT_SIZE + maxBlock));
+        smoother.prepare (sampleRate, maxBlock);
+        mixer.prepare (maxBlock);
         reset();
     }
 
     void reset() override
     {
-        for (int ch = 0; ch < 2; ++ch)
-        {
-            std::fill (inFifo[ch].begin(),     inFifo[ch].end(),     0.0f);
-            std::fill (outFifo[ch].begin(),    outFifo[ch].end(),    0.0f);
-            std::fill (outputAccum[ch].begin(),outputAccum[ch].end(),0.0f);
-        }
-        fifoIndex = 0;
-        for (int v = 0; v < MAX_VOICES; ++v) voiceLfoPhase[v] = 0.0f;
+        for (auto& r : resolutions)
+            r->reset();
+        dryDelay.clear();
+        dryWritePos = 0;
+        lfoPhase    = 0.0f;
+        activeMode  = noMode; // the next block adopts the snapshot's mode
+        fadeMode    = noMode;
+        wasBypassed = false;
+        smoother.reset();
+        mixer.reset();
     }
 
     //==============================================================================
-    void process (juce::dsp::AudioBlock<float>& block) override
+    void render (const NodeContext& context) noexcept override
     {
-        if (!isEnabled() || pEnabled->load() < 0.5f) return;
+        if (! isActive (context, ParamIndex::SWC_ENABLED))
+        {
+            wasBypassed  = true;
+            blockLatency = 0;
+            return;
+        }
+
+        // Stale frames and dry history would otherwise replay on re-enable
+        if (wasBypassed)
+            reset();
+
+        const int numSamples = context.numSamples;
 
-        const int numSamples = static_cast<int> (block.getNumSamples());
-        const float mix      = pMix->load();
+        // Every engine is clear after reset(); later changes fade in
+        if (const int mode = clampFrameMode (context.getParameter (ParamIndex::SWC_FRAME)); activeMode == noMode)
+            activeMode = mode;
+        else if (mode != activeMode && fadeMode == noMode)
+            beginModeFade (mode);
 
-        for (int s = 0; s < numSamples; ++s)
+        auto& primary = *resolutions[static_cast<size_t> (primaryResolution (activeMode))];
+        const int engineChannels = primary.getNumChannels();
+        const int channels       = juce::jmin (context.numChannels, engineChannels);
+
+        // Shared by every resolution's hops in this block
+        voices.count = juce::jlimit (0, MAX_VOICES, static_cast<int> (context.getParameter (ParamIndex::SWC_VOICES)));
+        voices.depth = pDepth.getValue (context.parameters, context.modulation);
+        voices.warp  = pWarp.getValue (context.parameters, context.modulation);
+        voices.lfoPhase = lfoPhase;
+        voices.lfoStep  = pRate.getValue (context.parameters, context.modulation) / static_cast<float> (sampleRate);
+        lfoPhase += voices.lfoStep * static_cast<float> (numSamples);
+        lfoPhase -= std::floor (lfoPhase);
+
+        // A mono block feeds both engine channels
+        const float* in[2] {};
+        for (int ch = 0; ch < engineChannels; ++ch)
+            in[ch] = context.channel (juce::jmin (ch, channels - 1));
+
+        renderMode (activeMode, in, wetBuf.getArrayOfWritePointers(), channels, numSamples);
+
+        if (fadeMode == noMode)
         {
-            for (int ch = 0; ch < numChannels && ch < 2; ++ch)
+            delayDry (context, channels, primary.getLatencySamples(), 0, nullptr);
+        }
+        else
+        {
+            // wet += gain · (incoming − outgoing), and the same blend on the dry delay
+            using FVO = juce::FloatVectorOperations;
+            renderMode (fadeMode, in, fadeBuf.getArrayOfWritePointers(), channels, numSamples);
+            const bool faded = advanceModeFade (numSamples);
+            for (int ch = 0; ch < channels; ++ch)
             {
-                inFifo[ch][fifoIndex] = block.getSample (ch, s);
-                block.setSample (ch, s,
-                    eqpCrossfade (block.getSample (ch, s),
-                                  outFifo[ch][fifoIndex], mix));
+                float* fade = fadeBuf.getWritePointer (ch);
+                FVO::subtract (fade, wetBuf.getReadPointer (ch), numSamples);
+                FVO::multiply (fade, fadeGains.data(), numSamples);
+                FVO::add (wetBuf.getWritePointer (ch), fade, numSamples);
             }
 
-            ++fifoIndex;
-            if (fifoIndex >= HOP_SIZE)
+            const int fadeDelay = resolutions[static_cast<size_t> (primaryResolution (fadeMode))]->getLatencySamples();
+            delayDry (context, channels, primary.getLatencySamples(), fadeDelay, fadeGains.data());
+
+            if (faded)
             {
-                fifoIndex = 0;
-                processSpectralFrame();
+                activeMode = fadeMode;
+                fadeMode   = noMode;
             }
         }
+
+        const bool incomingLouder = fadeMode != noMode && fadeGains[static_cast<size_t> (numSamples - 1)] >= 0.5f;
+        blockLatency = resolutions[static_cast<size_t> (primaryResolution (incomingLouder ? fadeMode : activeMode))]
+                           ->getLatencySamples();
+
+        // Equal-power dry/wet
+        smoother.process (context.parameters, context.modulation, numSamples);
+        mixer.update (smoother, mixSlot, numSamples);
+        for (int ch = 0; ch < channels; ++ch)
+            mixer.apply (context.channel (ch), wetBuf.getReadPointer (ch), numSamples);
     }
 
 private:
     //==============================================================================
-    void processSpectralFrame()
+    enum class Band { full, low, high };
+
+    static constexpr float ROTOR_TOLERANCE = 1.0f / 512.0f;
+
+    /** Voice settings for the current block, read by every resolution's hops. */
+    struct VoiceSettings
+    {
+        int   count    { 0 };
+        float depth    { 0.0f };
+        float warp     { 0.0f };
+        float lfoPhase { 0.0f }; // at the block's first sample
+        float lfoStep  { 0.0f }; // per sample, so each hop reads the LFO where it lands
+    };
+
+    //==============================================================================
+    /**
+     * One frame size's engine and per-bin gain tables, optionally limited
+     * to one side of the hybrid crossover. The band weight applies to the
+     * voices only. The dry spectrum rides on the full-band and the short
+     * (high) resolution at unit gain in every bin, so the long frame adds
+     * nothing but chorus and the hybrid's dry part never sums at two
+     * delays. Bins that carry neither dry nor voices are cleared and
+     * skipped by the gain update.
+     */
+    class Resolution final : private StftEngine::Subscriber
     {
-        const int   numVoices = static_cast<int> (pVoices->load());
-        const float depth     = pDepth->load();
-        const float warp      = pWarp->load();
-        const float lfoRate   = pRate->load() / static_cast<float> (sampleRate);
+    public:
+        explicit Resolution (SpectralWarpChorus& o) : owner (o) { stft.addSubscriber (this); }
+
+        void prepare (int fftOrder, int channels, Band band)
+        {
+            const int fftSize = 1 << fftOrder;
+            numBins  = fftSize / 2 + 1;
+            binScale = MAX_FFT_SIZE / fftSize;
+
+            stft.prepare (fftOrder, fftSize / 4, channels, true);
+            stft.setStereoPacking (true); // one complex FFT per hop for L and R
+
+            for (auto* t : { &rotorBaseRe, &rotorBaseIm, &rotorSinRe, &rotorSinIm,
+                             &rotorCosRe, &rotorCosIm, &binGainRe, &binGainIm, &binWeight })
+                t->assign (static_cast<size_t> (numBins * 2), 0.0f);
+
+            // Crossover weight per bin, on a log-frequency raised cosine
+            const float lowEdge  = HYBRID_CROSSOVER_HZ * juce::MathConstants<float>::sqrt2 * 0.5f;
+            const float highEdge = HYBRID_CROSSOVER_HZ * juce::MathConstants<float>::sqrt2;
+            carriesDry = band != Band::low;
+            firstBin   = carriesDry ? 0 : numBins;
+            endBin     = carriesDry ? numBins : 0;
+            for (int bin = 0; bin < numBins; ++bin)
+            {
+                const float hz = static_cast<float> (bin * owner.sampleRate / fftSize);
+                const float x  = hz <= lowEdge  ? 0.0f
+                               : hz >= highEdge ? 1.0f
+                               : std::log2 (hz / lowEdge); // edges are an octave apart
+                const float high = 0.5f - 0.5f * std::cos (x * juce::MathConstants<float>::pi);
+                const float w = band == Band::full ? 1.0f : band == Band::high ? high : 1.0f - high;
+
+                binWeight[static_cast<size_t> (bin * 2)] = binWeight[static_cast<size_t> (bin * 2 + 1)] = w;
+                if (w > 0.0f)
+                {
+                    firstBin = juce::jmin (firstBin, bin);
+                    endBin   = bin + 1;
+                }
+            }
+
+            rotorsValid = false;
+            gainsValid  = false;
+        }
+
+        void reset() noexcept { stft.reset(); }
+
+        void process (const float* const* input, float* const* output, int numSamples) noexcept
+        {
+            stft.process (input, output, numSamples);
+        }
 
-        for (int ch = 0; ch < numChannels && ch < 2; ++ch)
+        int getNumChannels() const noexcept    { return stft.getNumChannels(); }
+        int getLatencySamples() const noexcept { return stft.getLatencySamples(); }
+
+    private:
+        /** Original + all voices, as one complex gain per bin. */
+        void processFrame (StftEngine::Frame& frame) override
         {
-            // Copy fifo with windowing into fftData
-            std::copy (inFifo[ch].begin() + HOP_SIZE, inFifo[ch].end(),   fftData[ch].begin());
-            std::copy (inFifo[ch].begin(),             inFifo[ch].begin() + HOP_SIZE,
-                       fftData[ch].begin() + (FFT_SIZE - HOP_SIZE));
-            window.multiplyWithWindowingTable (fftData[ch].data(), FFT_SIZE);
+            updateBinGains (frame.blockOffset);
 
-            // Forward FFT (real → complex interleaved)
-            fft.performRealOnlyForwardTransform (fftData[ch].data(), true);
+            const int first = firstBin * 2, count = juce::jmax (0, endBin - firstBin);
+            for (int ch = 0; ch < frame.numChannels; ++ch)
+            {
+                float* spectrum = frame.spectra[ch];
+                juce::FloatVectorOperations::clear (spectrum, first);
+                juce::FloatVectorOperations::clear (spectrum + endBin * 2, (numBins - endBin) * 2);
+                SpectralOps::multiplyByComplexGain (spectrum + first, binGainRe.data() + first,
+                                                    binGainIm.data() + first, count);
+            }
+        }
 
-            // Accumulate voices in frequency domain
-            std::fill (voiceAccum.begin(), voiceAccum.end(), 0.0f);
+        /**
+         * Refresh the per-bin gain at this hop's LFO position: the block's
+         * start phase advanced to the sample the hop ended on
+         *
+         *   gain = (dry · (1 + voices) + w · Σ_v (R_v − 1 + R_v · k · sin (θ + θ_v))) / (voices + 1)
+         *
+         * where dry is 1 on resolutions that carry the dry spectrum. Over
+         * every band this sums to the single-frame (1 + Σ_v R_v · (1 + k ·
+         * sin)) / (voices + 1), and at depth 0 (R_v = 1, k = 0) it is exactly
+         * the dry. Expanded as base + sin θ · sinSum + cos θ · cosSum (w,
+         * the band weight, is folded into the sums), so a hop costs three
+         * vector multiply-adds regardless of the voice count.
+         */
+        void updateBinGains (int blockOffset)
+        {
+            const auto& v = owner.voices;
+
+            // Modulated depth and warp move every block; a rebuild costs a
+            // sin/cos per voice and bin, so small moves reuse the tables
+            if (! rotorsValid || v.count != rotorVoices
+                || std::abs (v.depth - rotorDepth) > ROTOR_TOLERANCE
+                || std::abs (v.warp - rotorWarp) > ROTOR_TOLERANCE)
+                rebuildRotorSums (v.count, v.depth, v.warp);
+
+            const float scale = 1.0f / static_cast<float> (v.count + 1);
+            const float k     = v.depth * 0.4f * scale;
+            const float theta = (v.lfoPhase + v.lfoStep * static_cast<float> (blockOffset)) * juce::MathConstants<float>::twoPi;
+            const float a     = k * std::sin (theta);
+            const float b     = k * std::cos (theta);
+
+            if (gainsValid && scale == gainScale && a == gainSin && b == gainCos)
+                return;
+
+            using FVO = juce::FloatVectorOperations;
+            const int first = firstBin * 2, n = juce::jmax (0, endBin - firstBin) * 2;
+            FVO::copyWithMultiply (binGainRe.data() + first, rotorBaseRe.data() + first, scale, n);
+            FVO::addWithMultiply  (binGainRe.data() + first, rotorSinRe.data()  + first, a,     n);
+            FVO::addWithMultiply  (binGainRe.data() + first, rotorCosRe.data()  + first, b,     n);
+            FVO::copyWithMultiply (binGainIm.data() + first, rotorBaseIm.data() + first, scale, n);
+            FVO::addWithMultiply  (binGainIm.data() + first, rotorSinIm.data()  + first, a,     n);
+            FVO::addWithMultiply  (binGainIm.data() + first, rotorCosIm.data()  + first, b,     n);
+
+            gainScale = scale; gainSin = a; gainCos = b;
+            gainsValid = true;
+        }
+
+        /** Sum each voice's per-bin rotor R_v = e^{iφ_v(bin)}: its departure from the dry, and LFO-weighted. */
+        void rebuildRotorSums (int numVoices, float depth, float warp)
+        {
+            for (auto* t : { &rotorBaseRe, &rotorBaseIm, &rotorSinRe, &rotorSinIm, &rotorCosRe, &rotorCosIm })
+                std::fill (t->begin(), t->end(), 0.0f);
+
+            const int lastBin = juce::jmin (endBin, numBins - 1); // Nyquist is not rotated
 
             for (int v = 0; v < numVoices; ++v)
             {
-                voiceLfoPhase[v] += lfoRate * HOP_SIZE;
-                if (voiceLfoPhase[v] > 1.0f) voiceLfoPhase[v] -= 1.0f;
-                const float lfo = std::sin (voiceLfoPhase[v] * juce::MathConstants<float>::twoPi);
+                // sin (θ + θ_v) = sin θ · cos θ_v + cos θ · sin θ_v
+                const float offset = owner.voiceLfoOffset[v] * juce::MathConstants<float>::twoPi;
+                const float wSin = std::cos (offset), wCos = std::sin (offset);
 
                 // Fractional bin shift (spectral warp)
-                const float shift = voiceDetune[v] * depth * warp * 3.0f; // ±3 bins max
-                const float mag_mod = 1.0f + lfo * depth * 0.4f;
+                const float shift = owner.voiceDetune[v] * depth * warp * 3.0f; // ±3 bins max
 
-                for (int bin = 1; bin < FFT_SIZE / 2 - 1; ++bin)
+                for (int bin = juce::jmax (1, firstBin); bin < lastBin; ++bin)
                 {
-                    const float re = fftData[ch][bin * 2];
-                    const float im = fftData[ch][bin * 2 + 1];
+                    if (binWeight[static_cast<size_t> (bin * 2)] == 0.0f)
+                        continue; // the other band's voices
 
-                    // Phase rotation (creates alien shimmer)
-                    const float phi = voicePhaseRand[v][bin % 512] * depth * 0.3f
-                                    + static_cast<float>(bin) * shift * 0.01f;
+                    // Phase rotation (creates alien shimmer), on the 2048-point grid
+                    const int gridBin = bin * binScale;
+                    const float phi = owner.voicePhaseRand[v][gridBin % 512] * depth * 0.3f
+                                    + static_cast<float>(gridBin) * shift * 0.01f;
                     const float cosP = std::cos (phi);
                     const float sinP = std::sin (phi);
 
-                    voiceAccum[bin * 2]     += (re * cosP - im * sinP) * mag_mod;
-                    voiceAccum[bin * 2 + 1] += (re * sinP + im * cosP) * mag_mod;
+                    for (int i = bin * 2; i < bin * 2 + 2; ++i)
+                    {
+                        rotorBaseRe[i] += cosP - 1.0f; rotorBaseIm[i] += sinP;
+                        rotorSinRe[i]  += cosP * wSin; rotorSinIm[i]  += sinP * wSin;
+                        rotorCosRe[i]  += cosP * wCos; rotorCosIm[i]  += sinP * wCos;
+                    }
                 }
             }
 
-            // Mix original + voices
-            const float voiceScale = 1.0f / (numVoices + 1);
-            for (int i = 0; i < FFT_SIZE; ++i)
-                fftData[ch][i] = (fftData[ch][i] + voiceAccum[i]) * voiceScale;
-
-            // Inverse FFT
-            fft.performRealOnlyInverseTransform (fftData[ch].data());
-            window.multiplyWithWindowingTable (fftData[ch].data(), FFT_SIZE);
-
-            // Overlap-add into output accumulator
-            for (int i = 0; i < FFT_SIZE; ++i)
-                outputAccum[ch][i] += fftData[ch][i];
-
-            // Copy hop to outFifo and shift accumulator
-            std::copy (outputAccum[ch].begin(), outputAccum[ch].begin() + HOP_SIZE,
-                       outFifo[ch].begin());
-            std::copy (outputAccum[ch].begin() + HOP_SIZE, outputAccum[ch].end(),
-                       outputAccum[ch].begin());
-            std::fill (outputAccum[ch].end() - HOP_SIZE, outputAccum[ch].end(), 0.0f);
+            // Band-weight the voices, then add the dry spectrum and the voices'
+            // dry-equal part unweighted: unit gain once scaled by 1 / (voices + 1)
+            using FVO = juce::FloatVectorOperations;
+            const int n = numBins * 2;
+            for (auto* t : { &rotorBaseRe, &rotorBaseIm, &rotorSinRe, &rotorSinIm, &rotorCosRe, &rotorCosIm })
+                FVO::multiply (t->data(), binWeight.data(), n);
+            if (carriesDry)
+                FVO::add (rotorBaseRe.data(), static_cast<float> (numVoices + 1), n);
+
+            rotorVoices = numVoices; rotorDepth = depth; rotorWarp = warp;
+            rotorsValid = true;
+            gainsValid  = false;
         }
+
+        SpectralWarpChorus& owner;
+        StftEngine stft;
+
+        int numBins  { 0 };
+        int binScale { 1 };           // bin → 2048-point grid
+        int firstBin { 0 }, endBin { 0 }; // bins with dry or a non-zero band weight
+        bool carriesDry { true };          // full band, or the hybrid's short frame
+
+        // Per-bin voice sums, each part duplicated per bin (see SpectralOps)
+        using BinTable = std::vector<float>;
+        BinTable rotorBaseRe, rotorBaseIm, rotorSinRe, rotorSinIm, rotorCosRe, rotorCosIm;
+        BinTable binGainRe, binGainIm, binWeight;
+
+        bool  rotorsValid { false }, gainsValid { false };
+        int   rotorVoices { 0 };
+        float rotorDepth { 0.0f }, rotorWarp { 0.0f };
+        float gainScale  { 0.0f }, gainSin   { 0.0f }, gainCos { 0.0f };
+
+        JUCE_DECLARE_NON_COPYABLE (Resolution)
+    };
+
+    //==============================================================================
+    static constexpr int    noMode     = -1;                // before the first block after reset()
+    static constexpr size_t hybridHigh = numFrameModes - 1; // 256 above the crossover
+    static constexpr size_t hybridLow  = numFrameModes;     // 2048 below it
+
+    static int clampFrameMode (float value) noexcept
+    {
+        return juce::jlimit (0, numFrameModes - 1, static_cast<int> (value));
+    }
+
+    /** Message thread (latency, prepare): the APVTS's current choice. */
+    int getFrameMode() const noexcept { return clampFrameMode (pFrame->load()); }
+
+    /** The resolution a mode's dry path is aligned to. */
+    static int primaryResolution (int mode) noexcept
+    {
+        return mode == hybrid ? static_cast<int> (hybridHigh) : mode;
+    }
+
+    /** The longest frame a mode runs, which sets how long it takes to fill. */
+    static int longestFrame (int mode) noexcept
+    {
+        return mode == hybrid ? MAX_FFT_SIZE : 1 << (MIN_FFT_ORDER + mode);
+    }
+
+    /** Wet output of one mode's resolutions; hybrid sums its two bands. */
+    void renderMode (int mode, const float* const* in, float* const* out, int channels, int numSamples) noexcept
+    {
+        resolutions[static_cast<size_t> (primaryResolution (mode))]->process (in, out, numSamples);
+
+        if (mode == hybrid)
+        {
+            resolutions[hybridLow]->process (in, hybridBuf.getArrayOfWritePointers(), numSamples);
+            for (int ch = 0; ch < channels; ++ch)
+                juce::FloatVectorOperations::add (out[ch], hybridBuf.getReadPointer (ch), numSamples);
+        }
+    }
+
+    /**
+     * Start bringing in a new frame mode. Its engines start empty and only
+     * match their steady output once every frame overlapping the aligned
+     * sample holds signal from after the switch: latency (one frame) plus
+     * one more frame.
+     */
+    void beginModeFade (int mode) noexcept
+    {
+        resolutions[static_cast<size_t> (primaryResolution (mode))]->reset();
+        if (mode == hybrid)
+            resolutions[hybridLow]->reset();
+
+        fadeMode   = mode;
+        fadeDone   = 0;
+        fadeWarmUp = 2 * longestFrame (mode);
+        fadeLength = juce::jmax (longestFrame (mode), longestFrame (activeMode)) / 4;
+    }
+
+    /** Fill fadeGains for this block: 0 while warming up, then a linear ramp to 1. True once complete. */
+    bool advanceModeFade (int numSamples) noexcept
+    {
+        const float step = 1.0f / static_cast<float> (fadeLength);
+        for (int i = 0; i < numSamples; ++i)
+            fadeGains[static_cast<size_t> (i)]
+                = juce::jlimit (0.0f, 1.0f, static_cast<float> (fadeDone + i + 1 - fadeWarmUp) * step);
+
+        fadeDone += numSamples;
+        return fadeDone >= fadeWarmUp + fadeLength;
+    }
+
+    /**
+     * Delay the block in place by the wet path's latency. While a mode
+     * change fades in, the read blends towards fadeDelay by the same gains
+     * as the wet.
+     */
+    void delayDry (const NodeContext& context, int channels, int delay, int fadeDelay,
+                   const float* gains) noexcept
+    {
+        const int numSamples = context.numSamples;
+        const int mask = dryDelay.getNumSamples() - 1;
+        for (int ch = 0; ch < channels; ++ch)
+        {
+            float* SNOT_RESTRICT x    = context.channel (ch);
+            float* SNOT_RESTRICT ring = dryDelay.getWritePointer (ch);
+
+            if (gains == nullptr)
+            {
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    const int w = (dryWritePos + i) & mask;
+                    ring[w] = x[i];
+                    x[i]    = ring[(w - delay) & mask];
+                }
+            }
+            else
+            {
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    const int w = (dryWritePos + i) & mask;
+                    ring[w] = x[i];
+                    const float outgoing = ring[(w - delay) & mask];
+                    x[i] = outgoing + (ring[(w - fadeDelay) & mask] - outgoing) * gains[i];
+                }
+            }
+        }
+        dryWritePos = (dryWritePos + numSamples) & mask;
     }
 
     //==============================================================================
     juce::AudioProcessorValueTreeState& apvts;
-    juce::dsp::FFT fft;
-    juce::dsp::WindowingFunction<float> window;
-
-    std::atomic<float>* pDepth   { nullptr };
-    std::atomic<float>* pRate    { nullptr };
-    std::atomic<float>* pVoices  { nullptr };
-    std::atomic<float>* pWarp    { nullptr };
-    std::atomic<float>* pMix     { nullptr };
+    std::array<std::unique_ptr<Resolution>, numFrameModes + 1> resolutions; // 4 sizes, hybrid high, hybrid low
+
+    ModulatedParameter  pDepth   { apvts, ParamIndex::SWC_DEPTH };
+    ModulatedParameter  pRate    { apvts, ParamIndex::SWC_RATE };
+    ModulatedParameter  pWarp    { apvts, ParamIndex::SWC_WARP };
+    ModulatedParameter  pMix     { apvts, ParamIndex::SWC_MIX };
+    ParameterSmoother   smoother;
+    const int mixSlot { smoother.add (pMix) };
+    EqualPowerMix       mixer;
+    std::atomic<float>* pFrame   { nullptr };
     std::atomic<float>* pEnabled { nullptr };
 
-    std::array<std::vector<float>, 2> inFifo, outFifo, fftData, outputAccum;
-    std::vector<float> voiceAccum = std::vector<float> (FFT_SIZE * 2, 0.0f);
+    juce::AudioBuffer<float> wetBuf, fadeBuf, hybridBuf, dryDelay;
+    std::vector<float> fadeGains; // per sample of the block, incoming mode's share
+    int  dryWritePos { 0 };
+    int  activeMode  { noMode };  // the mode being heard
+    int  fadeMode    { noMode };  // the mode fading in, if any
+    int  fadeDone    { 0 };       // samples since fadeMode's engines were reset
+    int  fadeWarmUp  { 0 };
+    int  fadeLength  { 1 };
+    bool wasBypassed { false };
+    int  blockLatency { 0 };      // what getBlockLatencySamples() reports
 
-    int fifoIndex { 0 };
     double sampleRate  { 44100.0 };
     int    numChannels { 2 };
 
-    float voiceLfoPhase[MAX_VOICES] {};
+    VoiceSettings voices;
+    float lfoPhase { 0.0f };
+    float voiceLfoOffset[MAX_VOICES] {};
     float voiceDetune[MAX_VOICES]   {};
     float voicePhaseRand[MAX_VOICES][512] {};
 
@@ -0,0 +1,94 @@
+/**
+ * Regression test for FftBackend's packed stereo transforms.
+ *
+ * For every backend and every size from 16 to 8192 points, forwardStereo()
+ * must match two forward() calls, and inverseStereo() must match two
+ * inverse() calls. Errors are measured relative to the spectrum's peak, and
+ * the round trip back to the input is checked too. Exits non-zero when any
+ * deviation exceeds TOLERANCE.
+ */
+#include <JuceHeader.h>
+#include "FftBackend.h"
+#include <iostream>
+
+namespace
+{
+    constexpr int    MIN_ORDER = 4;
+    constexpr int    MAX_ORDER = 13;
+    constexpr double TOLERANCE = 1.0e-4;
+
+    const char* getName (FftBackend::Kind kind)
+    {
+        return kind == FftBackend::Kind::juce ? "juce" : "bundled";
+    }
+
+    /** Worst deviation, relative to the spectrum's peak, for one backend and size. */
+    double measure (int order, FftBackend::Kind kind, juce::Random& random)
+    {
+        const auto size = static_cast<size_t> (1 << order);
+        const auto fft  = FftBackend::create (order, kind);
+
+        std::vector<float> l (size * 2, 0.0f), r (size * 2, 0.0f);
+        for (size_t i = 0; i < size; ++i)
+        {
+            l[i] = random.nextFloat() * 2.0f - 1.0f;
+            r[i] = random.nextFloat() * 2.0f - 1.0f;
+        }
+        const auto inL = l, inR = r;
+
+        // Forward: packed against two real transforms
+        auto refL = l, refR = r;
+        fft->forward (refL.data());
+        fft->forward (refR.data());
+        fft->forwardStereo (l.data(), r.data());
+
+        double peak = 1.0e-9, worst = 0.0;
+        for (size_t i = 0; i < size + 2; ++i)
+        {
+            peak  = juce::jmax (peak, static_cast<double> (std::abs (refL[i])), static_cast<double> (std::abs (refR[i])));
+            worst = juce::jmax (worst, static_cast<double> (std::abs (l[i] - refL[i])),
+                                       static_cast<double> (std::abs (r[i] - refR[i])));
+        }
+        worst /= peak;
+
+        // Inverse: packed against two real transforms of the same spectra
+        auto invL = refL, invR = refR;
+        fft->inverse (invL.data());
+        fft->inverse (invR.data());
+        fft->inverseStereo (refL.data(), refR.data());
+
+        for (size_t i = 0; i < size; ++i)
+        {
+            worst = juce::jmax (worst, static_cast<double> (std::abs (refL[i] - invL[i])),
+                                       static_cast<double> (std::abs (refR[i] - invR[i])));
+            worst = juce::jmax (worst, static_cast<double> (std::abs (refL[i] - inL[i])),
+                                       static_cast<double> (std::abs (refR[i] - inR[i])));
+        }
+
+        return worst;
+    }
+}
+
+//==============================================================================
+int main()
+{
+    juce::Random random (0x57e7);
+    int failures = 0;
+
+    for (int order = MIN_ORDER; order <= MAX_ORDER; ++order)
+    {
+        for (auto kind : { FftBackend::Kind::juce, FftBackend::Kind::bundled })
+        {
+            const double error = measure (order, kind, random);
+            const bool   ok    = error <= TOLERANCE;
+            failures += ok ? 0 : 1;
+
+            std::cout << (ok ? "PASS " : "FAIL ") << (1 << order) << " points, "
+                      << getName (kind) << ": max relative error " << error << "\n";
+        }
+    }
+
+    std::cout << (failures == 0 ? "all stereo packing checks passed" : "stereo packing checks failed")
+              << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,183 @@
+/**
+ * Regression test for SpectralWarpChorus's frame modes at depth 0.
+ *
+ * With no depth every voice equals the dry signal, so each frame mode must
+ * pass its input through unchanged apart from the latency it reports.
+ * Hybrid in particular must be a pure 256-sample delay: its long low-band
+ * frame may add chorus only, never a second, later copy of the signal
+ * summed across the crossover. The latency the node says it rendered with
+ * must match the one it reports up front. Exits non-zero when any sample
+ * after the engines have filled deviates from the delayed input by more
+ * than TOLERANCE.
+ */
+#include <JuceHeader.h>
+#include "PluginProcessor.h" // the modules reach their parameter table through it
+#include <iostream>
+
+namespace
+{
+    constexpr double SAMPLE_RATE = 48000.0;
+    constexpr int    BLOCK_SIZE  = 512;
+    constexpr int    NUM_BLOCKS  = 48;
+    constexpr int    SETTLE      = 2 * SpectralWarpChorus::MAX_FFT_SIZE + SpectralWarpChorus::MAX_FFT_SIZE;
+    constexpr double TOLERANCE   = 1.0e-3;
+
+    /** Just enough of a processor to own the plugin's parameter layout. */
+    class TestProcessor final : public juce::AudioProcessor
+    {
+    public:
+        TestProcessor()
+            : AudioProcessor (BusesProperties()
+                                  .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
+                                  .withOutput ("Output", juce::AudioChannelSet::stereo(), true)),
+              apvts (*this, nullptr, "SNOT_STATE", createLayout())
+        {
+        }
+
+        void set (const char* id, float value)
+        {
+            auto* param = apvts.getParameter (id);
+            param->setValueNotifyingHost (param->convertTo0to1 (value));
+        }
+
+        void prepareToPlay (double, int) override {}
+        void releaseResources() override {}
+        void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override {}
+        juce::AudioProcessorEditor* createEditor() override { return nullptr; }
+        bool hasEditor() const override { return false; }
+        const juce::String getName() const override { return "SwcFrameTransparencyTest"; }
+        bool acceptsMidi() const override { return false; }
+        bool producesMidi() const override { return false; }
+        double getTailLengthSeconds() const override { return 0.0; }
+        int getNumPrograms() override { return 1; }
+        int getCurrentProgram() override { return 0; }
+        void setCurrentProgram (int) override {}
+        const juce::String getProgramName (int) override { return {}; }
+        void changeProgramName (int, const juce::String&) override {}
+        void getStateInformation (juce::MemoryBlock&) override {}
+        void setStateInformation (const void*, int) override {}
+
+        juce::AudioProcessorValueTreeState apvts;
+
+    private:
+        /** The plugin's layout, from ParamIndex::table as SnotAudioProcessor builds it. */
+        static juce::AudioProcessorValueTreeState::ParameterLayout createLayout()
+        {
+            std::vector<std::unique_ptr<juce::RangedAudioParameter>> params;
+
+            for (const auto& spec : ParamIndex::table)
+            {
+                const juce::ParameterID id { spec.id, 1 };
+                switch (spec.kind)
+                {
+                    case ParamSpec::floatParam:
+                    {
+                        juce::NormalisableRange<float> range (spec.min, spec.max);
+                        range.skew = spec.skew;
+                        params.push_back (std::make_unique<juce::AudioParameterFloat> (id, spec.name, range, spec.def));
+                        break;
+                    }
+                    case ParamSpec::boolParam:
+                        params.push_back (std::make_unique<juce::AudioParameterBool> (id, spec.name, spec.def >= 0.5f));
+                        break;
+                    case ParamSpec::choiceParam:
+                        params.push_back (std::make_unique<juce::AudioParameterChoice> (
+                            id, spec.name, juce::StringArray::fromTokens (spec.choices, "|", ""), static_cast<int> (spec.def)));
+                        break;
+                }
+            }
+
+            return { params.begin(), params.end() };
+        }
+    };
+
+    const char* getName (int mode)
+    {
+        static const char* const names[] { "256", "512", "1024", "2048", "hybrid" };
+        return names[mode];
+    }
+
+    /** Worst deviation from the delayed input, after SETTLE samples, for one frame mode. */
+    double measure (TestProcessor& proc, int mode, int& latency, int& blockLatency, juce::Random& random)
+    {
+        proc.set (ParamID::SWC_FRAME, static_cast<float> (mode));
+
+        ParameterSnapshot snapshot (proc.apvts);
+        ModulationBuses   buses (ParamIndex::NUM_PARAMS);
+        SpectralWarpChorus swc (proc.apvts);
+        swc.setBlockSources (&snapshot.getValues(), &buses, &snapshot.getTransport());
+        swc.prepare ({ SAMPLE_RATE, static_cast<juce::uint32> (BLOCK_SIZE), 2 });
+        latency = swc.getLatencySamples();
+
+        const int total = BLOCK_SIZE * NUM_BLOCKS;
+        std::vector<float> inL (static_cast<size_t> (total)), inR (static_cast<size_t> (total));
+        for (int i = 0; i < total; ++i)
+        {
+            inL[static_cast<size_t> (i)] = random.nextFloat() * 2.0f - 1.0f;
+            inR[static_cast<size_t> (i)] = random.nextFloat() * 2.0f - 1.0f;
+        }
+
+        juce::AudioBuffer<float> buffer (2, BLOCK_SIZE);
+        double worst = 0.0;
+
+        for (int b = 0; b < NUM_BLOCKS; ++b)
+        {
+            const int start = b * BLOCK_SIZE;
+            buffer.copyFrom (0, 0, inL.data() + start, BLOCK_SIZE);
+            buffer.copyFrom (1, 0, inR.data() + start, BLOCK_SIZE);
+
+            snapshot.capture();
+            buses.beginBlock();
+            juce::dsp::AudioBlock<float> block (buffer);
+            swc.process (block);
+
+            for (int i = 0; i < BLOCK_SIZE; ++i)
+            {
+                const int n = start + i;
+                if (n < SETTLE)
+                    continue;
+
+                const auto src = static_cast<size_t> (n - latency);
+                worst = juce::jmax (worst,
+                                    static_cast<double> (std::abs (buffer.getSample (0, i) - inL[src])),
+                                    static_cast<double> (std::abs (buffer.getSample (1, i) - inR[src])));
+            }
+        }
+
+        blockLatency = swc.getBlockLatencySamples();
+        return worst;
+    }
+}
+
+//==============================================================================
+int main()
+{
+    TestProcessor proc;
+    proc.set (ParamID::SWC_DEPTH,   0.0f);
+    proc.set (ParamID::SWC_VOICES,  4.0f);
+    proc.set (ParamID::SWC_WARP,    1.0f);
+    proc.set (ParamID::SWC_MIX,     1.0f);
+    proc.set (ParamID::SWC_ENABLED, 1.0f);
+
+    juce::Random random (0x5c0c);
+    int failures = 0;
+
+    for (int mode = SpectralWarpChorus::frame256; mode < SpectralWarpChorus::numFrameModes; ++mode)
+    {
+        int latency = 0, blockLatency = 0;
+        const double error = measure (proc, mode, latency, blockLatency, random);
+        const bool ok = error <= TOLERANCE
+                     && latency == (mode == SpectralWarpChorus::hybrid ? 256 : 256 << mode)
+                     && blockLatency == latency;
+
+        std::cout << (ok ? "ok   " : "FAIL ") << getName (mode)
+                  << "  latency " << latency << " (rendered " << blockLatency << ")"
+                  << "  max error " << error << "\n";
+        failures += ok ? 0 : 1;
+    }
+
+    if (failures > 0)
+        std::cout << failures << " frame mode(s) are not transparent at depth 0\n";
+
+    return failures > 0 ? 1 : 0;
+}